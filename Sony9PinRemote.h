@@ -8,11 +8,26 @@
 
 #if defined(ARDUINO) || defined(OF_VERSION_MAJOR) || defined(QT_VERSION)
 #define SONY9PINREMOTE_ENABLE_STREAM
+#elif defined(__unix__) || defined(__APPLE__)
+#define SONY9PINREMOTE_ENABLE_STREAM
+#define SONY9PINREMOTE_POSIX
 #endif
 
 #include "Sony9PinRemote/Types.h"
+#include "Sony9PinRemote/Commands.h"
+#include "Sony9PinRemote/Clock.h"
 #include "Sony9PinRemote/Encoder.h"
 #include "Sony9PinRemote/Decoder.h"
+#include "Sony9PinRemote/TimeCode.h"
+#include "Sony9PinRemote/TimeCodePredictor.h"
+#include "Sony9PinRemote/CommandQueue.h"
+#include "Sony9PinRemote/LatencyHistogram.h"
+#include "Sony9PinRemote/SenseCache.h"
+#include "Sony9PinRemote/Handlers.h"
+#include "Sony9PinRemote/Capture.h"
+#ifdef SONY9PINREMOTE_POSIX
+#include "Sony9PinRemote/PosixSerial.h"
+#endif
 
 #ifdef SONY9PINREMOTE_DEBUGLOG_ENABLE
 #include <DebugLogEnable.h>
@@ -20,6 +35,50 @@
 #include <DebugLogDisable.h>
 #endif
 
+// size of the receive buffer owned by each Controller (must be power of 2)
+#ifndef SONY9PINREMOTE_RX_BUFFER_SIZE
+#define SONY9PINREMOTE_RX_BUFFER_SIZE 64
+#endif
+
+// The defaults below are smaller on Arduino to fit boards with a few KB of SRAM (e.g. AVR).
+
+// max number of commands which can be queued by each Controller
+#ifndef SONY9PINREMOTE_COMMAND_QUEUE_SIZE
+#ifdef ARDUINO
+#define SONY9PINREMOTE_COMMAND_QUEUE_SIZE 4
+#else
+#define SONY9PINREMOTE_COMMAND_QUEUE_SIZE 8
+#endif
+#endif
+
+// max number of status change events kept by each Controller
+#ifndef SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE
+#ifdef ARDUINO
+#define SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE 8
+#else
+#define SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE 32
+#endif
+#endif
+
+// max number of commands (Cmd1, Cmd2) whose round-trip latency is recorded by each Controller
+// (0 to disable; each one takes ~200 bytes)
+#ifndef SONY9PINREMOTE_LATENCY_HISTOGRAM_SIZE
+#ifdef ARDUINO
+#define SONY9PINREMOTE_LATENCY_HISTOGRAM_SIZE 0
+#else
+#define SONY9PINREMOTE_LATENCY_HISTOGRAM_SIZE 8
+#endif
+#endif
+
+// max number of sense returns (Cmd2) whose latest reply is kept by each Controller
+#ifndef SONY9PINREMOTE_SENSE_CACHE_SIZE
+#ifdef ARDUINO
+#define SONY9PINREMOTE_SENSE_CACHE_SIZE 4
+#else
+#define SONY9PINREMOTE_SENSE_CACHE_SIZE 8
+#endif
+#endif
+
 namespace sony9pin {
 
 #ifdef SONY9PINREMOTE_ENABLE_STREAM
@@ -27,17 +86,12 @@ namespace sony9pin {
 // Arduino
 #ifdef ARDUINO
 using StreamType = Stream;
-#define SONY9PINREMOTE_STREAM_WRITE(data, size)     \
-    if (size > 0) {                                 \
-        if (b_force_send || !b_wait_for_response) { \
-            stream->write(data, size);              \
-            b_wait_for_response = true;             \
-        }                                           \
-    }
+#define SONY9PINREMOTE_STREAM_WRITE(data, size) stream->write(data, size)
 #define SONY9PINREMOTE_STREAM_READ(data, size) stream->readBytes(data, size)
 #define SONY9PINREMOTE_STREAM_AVAILABLE() stream->available()
 #define SONY9PINREMOTE_STREAM_FLUSH() stream->flush()
-#define SONY9PINREMOTE_ELAPSED_MILLIS() millis()
+#define SONY9PINREMOTE_STREAM_WAIT(timeout_us) ((void)(timeout_us), yield())
+using DefaultClock = ArduinoClock;
 namespace serial {
     static constexpr size_t BAUDRATE {38400};
     static constexpr size_t CONFIG {SERIAL_8O1};
@@ -46,17 +100,13 @@ namespace serial {
 // openFrameworks
 #elif defined(OF_VERSION_MAJOR)
 using StreamType = ofSerial;
-#define SONY9PINREMOTE_STREAM_WRITE(data, size)     \
-    if (size > 0) {                                 \
-        if (b_force_send || !b_wait_for_response) { \
-            stream->writeBytes(data, size);         \
-            b_wait_for_response = true;             \
-        }                                           \
-    }
+#define SONY9PINREMOTE_STREAM_WRITE(data, size) stream->writeBytes(data, size)
 #define SONY9PINREMOTE_STREAM_READ(data, size) stream->readBytes(data, size)
 #define SONY9PINREMOTE_STREAM_AVAILABLE() stream->available()
 #define SONY9PINREMOTE_STREAM_FLUSH() stream->flush()
-#define SONY9PINREMOTE_ELAPSED_MILLIS() ofGetElapsedTimeMillis()
+// ofSerial has no readiness notification
+#define SONY9PINREMOTE_STREAM_WAIT(timeout_us) (((timeout_us) >= 1000) ? ofSleepMillis(1) : (void)0)
+using DefaultClock = SteadyClock;
 namespace serial {
     static constexpr size_t BAUDRATE {38400};
     // static constexpr size_t CONFIG {SERIAL_8O1};
@@ -64,28 +114,38 @@ namespace serial {
 
 // Qt
 #elif defined(QT_VERSION)
-#include <time.h>
 using StreamType = QSerialPort;
-#define SONY9PINREMOTE_STREAM_WRITE(data, size)        \
-    if (size > 0) {                                    \
-        if (b_force_send || !b_wait_for_response) {    \
-            stream->write((const char*)data, size);    \
-            if (!stream->waitForBytesWritten()) {      \
-                LOG_ERROR("Writing to serial FAILED"); \
-            }                                          \
-            b_wait_for_response = true;                \
-        }                                              \
-    }
+// 0 if the write or waitForBytesWritten() fails (QSerialPort only buffers the bytes in write())
+#define SONY9PINREMOTE_STREAM_WRITE(data, size)                                                     \
+    (((stream->write((const char*)data, size) == (qint64)(size)) && stream->waitForBytesWritten()) \
+         ? (qint64)(size)                                                                           \
+         : (qint64)0)
 #define SONY9PINREMOTE_STREAM_READ(data, size) stream->read((char*)data, size)
 #define SONY9PINREMOTE_STREAM_AVAILABLE() stream->waitForReadyRead(1) ? stream->bytesAvailable() : 0
 #define SONY9PINREMOTE_STREAM_FLUSH() stream->flush()
-#define SONY9PINREMOTE_ELAPSED_MILLIS() uint32_t((double)(clock()) / (CLOCKS_PER_SEC / 1000))
+#define SONY9PINREMOTE_STREAM_WAIT(timeout_us) \
+    (stream->bytesAvailable() > 0 || stream->waitForReadyRead((int)((timeout_us) / 1000 + 1)))
+using DefaultClock = SteadyClock;  // clock() is the CPU time, which stops while waiting for the port
 namespace serial {
     static constexpr size_t BAUDRATE {QSerialPort::Baud38400};
     // static constexpr size_t CONFIG {SERIAL_8O1};
 }  // namespace serial
 
-#endif  // ARDUINO / OF_VERSION_MAIJOR / QT_VERSION
+// Linux / macOS (termios)
+#elif defined(SONY9PINREMOTE_POSIX)
+using StreamType = PosixSerial;
+#define SONY9PINREMOTE_STREAM_WRITE(data, size) stream->write(data, size)
+#define SONY9PINREMOTE_STREAM_READ(data, size) stream->read(data, size)
+#define SONY9PINREMOTE_STREAM_AVAILABLE() stream->available()
+#define SONY9PINREMOTE_STREAM_FLUSH() stream->flush()
+#define SONY9PINREMOTE_STREAM_WAIT(timeout_us) stream->wait(timeout_us)
+using DefaultClock = SteadyClock;
+namespace serial {
+    static constexpr size_t BAUDRATE {38400};
+    // 8O1 is configured by PosixSerial::open()
+}  // namespace serial
+
+#endif  // ARDUINO / OF_VERSION_MAIJOR / QT_VERSION / SONY9PINREMOTE_POSIX
 // Not Supported
 #else  // SONY9PINREMOTE_ENABLE_STREAM
 
@@ -93,7 +153,10 @@ namespace serial {
 
 #endif  // SONY9PINREMOTE_ENABLE_STREAM
 
-class Controller {
+// `Clock` provides the time for timeouts, latency measurement and frame pacing (see Clock.h).
+// Use `Controller` for the default clock of the platform, or e.g. `BasicController<FakeClock>` in tests.
+template <typename Clock>
+class BasicController {
     // reference
     // https://en.wikipedia.org/wiki/9-Pin_Protocol
     // https://www.drastic.tv/support-59/legacysoftwarehardware/37-miscellaneous-legacy/180-vvcr-422-serial-protocol
@@ -103,805 +166,1012 @@ class Controller {
     Decoder decoder;
 
     uint16_t dev_type {0xFFFF};
-    Status sts;
+    RawStatus sts;
     Errors err;
     size_t err_count {0};
+    size_t unexpected_replies {0};
 
     uint8_t status_start {0};
     uint8_t status_size {10};
 
     bool b_force_send {false};
     bool b_wait_for_response {false};
+    bool b_hold {false};
+
+    static constexpr size_t RX_BUFFER_SIZE {SONY9PINREMOTE_RX_BUFFER_SIZE};
+    static constexpr size_t RX_BUFFER_MASK {RX_BUFFER_SIZE - 1};
+    static_assert((RX_BUFFER_SIZE & RX_BUFFER_MASK) == 0, "SONY9PINREMOTE_RX_BUFFER_SIZE must be power of 2");
+    uint8_t rx_buffer[RX_BUFFER_SIZE];
+    size_t rx_head {0};  // next byte to be fed to decoder
+    size_t rx_tail {0};  // next byte to be received from stream
+
+    CommandQueue<SONY9PINREMOTE_COMMAND_QUEUE_SIZE> queue;
+    uint32_t reply_timeout_us {100000};
+
+    // transmit scheduler: at most one command per frame
+    FrameRate frame_rate {FrameRate::NONE};
+    uint32_t next_slot_us {0};  // earliest time the next command can be written
+    QueueDelayStats delay_stats;
+    LatencyHistograms<SONY9PINREMOTE_LATENCY_HISTOGRAM_SIZE> latency_histograms;
+
+    // status change events (ring buffer, the oldest one is dropped if full)
+    StatusEvent status_events[SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE];
+    size_t status_event_head {0};
+    size_t status_event_count {0};
+    size_t status_event_lost {0};
+
+    TimeCodePredictor predictor;
+    uint32_t tc_latency_us {0};
+    SenseCache<SONY9PINREMOTE_SENSE_CACHE_SIZE> sense_returns;
+
+    CaptureHook capture_hook {nullptr};
+    void* capture_context {nullptr};
 
 public:
     void attach(StreamType& s, const bool force_send = false) {
         b_force_send = force_send;
         stream = &s;
         SONY9PINREMOTE_STREAM_FLUSH();
+        // discard everything which has come before attached
         while (const size_t size = SONY9PINREMOTE_STREAM_AVAILABLE()) {
-            uint8_t* data = new uint8_t[size];
-            SONY9PINREMOTE_STREAM_READ(data, size);
-            delete[] data;
+            SONY9PINREMOTE_STREAM_READ(rx_buffer, size < sizeof(rx_buffer) ? size : sizeof(rx_buffer));
         }
+        rx_head = rx_tail = 0;
+        decoder.reset();
+        queue.clear();
+        b_wait_for_response = false;
+        next_slot_us = Clock::micros();
     }
 
+    // Returns true every time one reply packet is completed.
+    // Bytes following the packet are kept in the receive buffer and fed at the next call,
+    // so call this repeatedly (e.g. `while (deck.parse())`) to get all packets of a burst.
     bool parse() {
-        while (const size_t size = SONY9PINREMOTE_STREAM_AVAILABLE()) {
-            uint8_t* data = new uint8_t[size];
-            SONY9PINREMOTE_STREAM_READ(data, size);
-            for (size_t i = 0; i < size; ++i) {
-                if (decoder.feed(data[i])) {
-                    // store the data which is useful if it can be referred anytime we want
-                    switch (decoder.cmd1()) {
-                        case Cmd1::SYSTEM_CONTROL_RETURN: {
-                            switch (decoder.cmd2()) {
-                                case SystemControlReturn::NAK: {
-                                    err_count++;
-                                    err = decoder.nak();
-                                    break;
-                                }
-                                case SystemControlReturn::DEVICE_TYPE: {
-                                    dev_type = decoder.device_type();
-                                    break;
-                                }
-                            }
-                        }
-                        // Fallthrough
-                        case Cmd1::SENSE_RETURN: {
-                            if (decoder.cmd2() == SenseReturn::STATUS_DATA) {
-                                // decode status based on requested range by `status_sense()`
-                                sts = decoder.status_sense(status_start, status_size);
-                            }
-                            break;
-                        }
-                        default:
-                            break;
-                    }
-                    b_wait_for_response = false;
-                    delete[] data;
+        NullHandlers handlers;
+        return parse(handlers);
+    }
+
+    // Same as above, and the completed packet is passed to the handler of its type (see NullHandlers).
+    template <typename Handlers>
+    bool parse(Handlers& handlers) {
+        // everything already received is fed before the deadlines are checked in `update()`,
+        // so that a reply waiting in the stream is not taken as a timeout when parse() is called late
+        while (true) {
+            while (rx_head != rx_tail || decoder.pending()) {
+                const size_t idx = rx_head & RX_BUFFER_MASK;
+                const size_t buffered = rx_tail - rx_head;
+                const size_t contiguous = RX_BUFFER_SIZE - idx;
+                const FeedResult result = decoder.feed(rx_buffer + idx, (buffered < contiguous) ? buffered : contiguous);
+                rx_head += result.consumed;
+                if (result.packets > 0) {
+                    on_reply();
+                    dispatch_reply(handlers);
                     return true;
                 }
             }
-            delete[] data;
+            if (receive() == 0)
+                break;
         }
+        update();
         return false;
     }
 
+    // Returns true as soon as one reply packet is completed, or false after `timeout_ms`.
+    // Between the attempts it sleeps on the stream (poll() on POSIX, waitForReadyRead() on Qt,
+    // yield() on Arduino) until a byte arrives, the timeout expires or the queue needs `update()`.
     bool parse_until(const uint32_t timeout_ms) {
-        const uint32_t begin_ms = SONY9PINREMOTE_ELAPSED_MILLIS();
+        NullHandlers handlers;
+        return parse_until(timeout_ms, handlers);
+    }
+
+    template <typename Handlers>
+    bool parse_until(const uint32_t timeout_ms, Handlers& handlers) {
+        // accumulate the differences so that neither the wrap-around of the clock
+        // nor a timeout longer than its range breaks the loop
+        const uint64_t timeout_us = (uint64_t)timeout_ms * 1000;
+        uint64_t elapsed_us = 0;
+        uint32_t prev_us = Clock::micros();
         while (true) {
-            if (parse())
+            if (parse(handlers))
                 return true;
-            if (SONY9PINREMOTE_ELAPSED_MILLIS() > begin_ms + timeout_ms)
+            const uint32_t now_us = Clock::micros();
+            elapsed_us += (uint32_t)(now_us - prev_us);
+            prev_us = now_us;
+            if (elapsed_us > timeout_us)
                 return false;
+            const uint64_t remaining_us = timeout_us - elapsed_us + 1;
+            const uint32_t event_us = next_event_us(now_us);
+            const uint32_t wait_us = (remaining_us < event_us) ? (uint32_t)remaining_us : event_us;
+            SONY9PINREMOTE_STREAM_WAIT(wait_us);
         }
     }
 
-    bool ready() const { return b_force_send ? true : (!decoder.busy() && !b_wait_for_response); }
+    // Commands are queued and sent one by one; the next one goes out as soon as
+    // the reply of the previous one arrives (or it times out in `update()`)
+    // and, if the frame rate is set, one frame has passed since the last one.
+    // Call `parse()` or `update()` regularly to keep the queue moving.
+    void update() {
+        CommandRecord* r = queue.front();
+        if (r && r->status == CommandStatus::SENT) {
+            const uint32_t now = Clock::micros();
+            if ((int32_t)(now - r->deadline_us) >= 0) {
+                LOG_WARN("reply timeout: cmd1", DebugLogBase::HEX, (uint8_t)r->cmd1(), "cmd2", r->cmd2());
+                r->status = CommandStatus::TIMEOUT;
+                latency_histograms.add_timeout(r->cmd1(), r->cmd2());
+                queue.pop();
+                b_wait_for_response = in_flight();  // a command written by send_now() may follow
+                // drop the partial reply, but not the bytes which may still be rescanned into packets
+                if (!decoder.pending()) decoder.reset();
+            }
+        }
+        dispatch();
+    }
+
+    // Queue an encoded packet (e.g. from Encoder) and send it if nothing is waiting for the reply.
+    // Every command method below is a shorthand of this, so they are queued behind the command
+    // in flight and the frame slot; use `send_now()` / `stop_now()` to bypass them.
+    CommandId send(const uint8_t* data, const size_t size) {
+        if (size == 0) return 0;
+        if (b_force_send && frame_rate == FrameRate::NONE && !b_hold) {
+            write(data, size, Clock::micros());
+            return 0;
+        }
+        CommandRecord* r = queue.push(data, (uint8_t)size, expected_reply(data), Clock::micros());
+        if (!r) {
+            LOG_WARN("command queue is full: cmd1", DebugLogBase::HEX, data[0], "cmd2", data[1]);
+            return 0;
+        }
+        const CommandId id = r->id;
+        dispatch();
+        return id;
+    }
+
+    // queue a packet encoded at compile time (see `prebuilt` in Encoder.h)
+    template <typename P>
+    CommandId send() {
+        LOG_INFO(DebugLogBase::HEX, "prebuilt cmd1:", P::data[0], "cmd2:", P::data[1]);
+        return send(P::data, P::size);
+    }
+
+    // Write a packet at once regardless of hold, the frame slot and the queued commands
+    // (e.g. an emergency stop). The device replies in order, so its record is placed right after
+    // the commands already written and waiting for the replies, and the queued ones follow its reply.
+    // The packet is written even if the queue is full (returns 0 as its reply is not tracked then).
+    CommandId send_now(const uint8_t* data, const size_t size) {
+        if (size == 0) return 0;
+        const uint32_t now = Clock::micros();
+        write(data, size, now);
+        const uint32_t interval = frame_interval_us(frame_rate);
+        if (interval > 0) next_slot_us = now + interval;  // the queued ones wait for the next slot
+        if (b_force_send) return 0;
+
+        size_t pos = 0;
+        while (pos < queue.size() && queue.at(pos)->status == CommandStatus::SENT) ++pos;
+        CommandRecord* r = queue.insert(pos, data, (uint8_t)size, expected_reply(data), now);
+        if (!r) {
+            LOG_WARN("command queue is full, reply not tracked: cmd1", DebugLogBase::HEX, data[0], "cmd2", data[1]);
+            return 0;
+        }
+        r->status = CommandStatus::SENT;
+        r->sent_us = now;
+        r->deadline_us = now + reply_timeout_us;
+        b_wait_for_response = true;
+        return r->id;
+    }
+
+    // write a packet encoded at compile time at once (single write of the constant buffer)
+    template <typename P>
+    CommandId send_now() {
+        LOG_INFO(DebugLogBase::HEX, "prebuilt cmd1:", P::data[0], "cmd2:", P::data[1]);
+        return send_now(P::data, P::size);
+    }
+
+    // Remove a command which is still queued (not written yet), e.g. when it is no longer wanted
+    // after an abort. Returns false if it has been written already or is not found.
+    bool cancel(const CommandId id) {
+        for (size_t i = 0; i < queue.size(); ++i) {
+            CommandRecord* r = queue.at(i);
+            if (r->id != id) continue;
+            if (r->status != CommandStatus::QUEUED) return false;
+            r->status = CommandStatus::CANCELLED;
+            return queue.erase(i);
+        }
+        return false;
+    }
+
+    // While held, commands are queued but not written. Releasing writes the first one at once,
+    // so that commands staged on several decks go out back to back (see GroupRoll.h).
+    void hold(const bool b) {
+        b_hold = b;
+        if (!b) dispatch();
+    }
+    bool is_held() const { return b_hold; }
+
+    // true if a command sent now is written immediately
+    // (nothing is queued or waiting for the reply, and the frame slot has come)
+    bool idle() const {
+        if (!queue.empty() || (b_wait_for_response && !b_force_send)) return false;
+        return (frame_rate == FrameRate::NONE) || ((int32_t)(Clock::micros() - next_slot_us) >= 0);
+    }
+
+    // Time from `now` (of `Clock`) until `update()` has something to do, which is
+    // the reply timeout of the command in flight or the frame slot of the next queued one.
+    // 0xFFFFFFFF if nothing is queued. Event loops can sleep until then.
+    uint32_t next_event_us(const uint32_t now) const {
+        const CommandRecord* r = queue.front();
+        if (!r || (b_hold && r->status == CommandStatus::QUEUED)) return 0xFFFFFFFF;
+        const uint32_t at = (r->status == CommandStatus::SENT) ? r->deadline_us : next_slot_us;
+        const int32_t d = (int32_t)(at - now);
+        return (d > 0) ? (uint32_t)d : 0;
+    }
+
+    // record of the command returned by the command methods (nullptr if already overwritten)
+    const CommandRecord* command(const CommandId id) const { return queue.find(id); }
+    size_t queued() const { return queue.size(); }
+    void set_reply_timeout(const uint32_t ms) { reply_timeout_us = ms * 1000; }
+    void set_reply_timeout_us(const uint32_t us) { reply_timeout_us = us; }
+
+    // Release at most one command per frame to avoid NAK (BUFFER_OVERRUN).
+    // This also applies to `force_send` mode, in which commands are then queued
+    // and written on every frame without waiting for the replies.
+    void set_frame_rate(const FrameRate fps) {
+        frame_rate = fps;
+        predictor.set_frame_rate(fps);
+    }
+    FrameRate get_frame_rate() const { return frame_rate; }
+    const QueueDelayStats& queue_delay() const { return delay_stats; }
+    void reset_queue_delay() { delay_stats = QueueDelayStats(); }
+
+    // Round-trip latency from the write of each command to its completed reply,
+    // kept per (Cmd1, Cmd2) of the command (e.g. `Cmd1::TRANSPORT_CONTROL, TransportCtrl::PLAY`).
+    // Not recorded in `force_send` mode because the replies are not correlated with the commands.
+    bool latency(const Cmd1 cmd1, const uint8_t cmd2, LatencySnapshot& s) const { return latency_histograms.snapshot(cmd1, cmd2, s); }
+    LatencySnapshot latency(const size_t i) const { return latency_histograms.snapshot(i); }
+    size_t latency_size() const { return latency_histograms.size(); }
+    size_t latency_untracked() const { return latency_histograms.untracked(); }  // all slots were used by other commands
+    void reset_latency() { latency_histograms.clear(); }
+
+    bool ready() const { return b_force_send ? true : (!decoder.busy() && !b_wait_for_response && queue.empty()); }
     bool available() const { return decoder.available(); }
 
     uint16_t device_type() const { return dev_type; }
-    const Status& status() const { return sts; }
+    Status status() const { return sts.to_status(); }
+    const RawStatus& raw_status() const { return sts; }
+
+    // Every STATUS DATA reply is compared with the previous status and
+    // one event is queued for each bit which has flipped.
+    // The first reply is compared with all-cleared status, so it reports every bit which is set.
+    // Returns false if there is no event.
+    bool next_status_event(StatusEvent& e) {
+        if (status_event_count == 0) return false;
+        e = status_events[status_event_head];
+        status_event_head = (status_event_head + 1) % SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE;
+        --status_event_count;
+        return true;
+    }
+    size_t status_events_available() const { return status_event_count; }
+    size_t status_events_lost() const { return status_event_lost; }  // dropped because the queue was full
+    void clear_status_events() { status_event_head = status_event_count = 0; }
+
+    // Timecode extrapolated from the last current time reply (TIMER-1/2, LTC, VITC and their
+    // interpolated / hold variants) and the transport mode in the status, so that the timecode
+    // can be read every frame while `current_time_sense_*()` is polled only a few times per second.
+    // The frame rate must be set by `set_frame_rate()`; otherwise the last reply is returned as is.
+    // Poll `status_sense()` too, because the prediction depends on play / still / var / shuttle / jog.
+    // If several sources are polled (e.g. LTC and TIMER-1), the prediction follows the latest reply,
+    // and the speed and `prediction_error()` are measured between the replies of the same source.
+    // The prediction is limited to 30 minutes after the last reply (`TimeCodePredictor::MAX_ANCHOR_AGE_US`).
+    // After that the last reply is returned as is and `is_timecode_anchor_stale()` returns true.
+    TimeCode predicted_timecode() const { return predictor.predict(Clock::micros(), sts); }
+    bool has_timecode_anchor() const { return predictor.anchored(); }
+    bool is_timecode_anchor_stale() const { return predictor.stale(Clock::micros()); }
+    // Use only the replies of one source (Cmd2 of the sense return, e.g. `SenseReturn::LTC_TC`),
+    // or `TimeCodePredictor::ANY_SOURCE` (default) for all.
+    void set_timecode_source(const uint8_t source) { predictor.set_source(source); }
+    uint8_t get_timecode_source() const { return predictor.get_source(); }
+    // The timecode in a reply is assumed to be latched at the middle of the round trip of the request.
+    // Additional latency of the device can be compensated here.
+    void set_timecode_latency(const uint32_t us) { tc_latency_us = us; }
+    // difference between the actual replies and the predicted timecode at the same time [frames]
+    const PredictionStats& prediction_error() const { return predictor.error(); }
+    void reset_prediction_error() { predictor.reset_error(); }
+    // Latest reply of every sense return except STATUS DATA with its receive time
+    // (e.g. `sense_cache().ltc_tc()`), while the accessors below return the current packet only.
+    // It can be read from another thread while `parse()` runs (seqlock, see SenseCache.h);
+    // call `clear_sense_cache()` from the thread calling `parse()`.
+    const SenseCache<SONY9PINREMOTE_SENSE_CACHE_SIZE>& sense_cache() const { return sense_returns; }
+    void clear_sense_cache() { sense_returns.clear(); }
+
     const Errors& errors() const { return err; }
     size_t error_count() const { return err_count; }
+    // replies which do not match the command in flight (e.g. a late reply to a timed-out command);
+    // they update the state like unsolicited ones, but the command keeps waiting for its own reply
+    size_t unexpected_reply_count() const { return unexpected_replies; }
+
+    // Called with every block written to / read from the stream (nullptr to disable).
+    // Use `CaptureWriter::hook` to record the link into a capture file (see Capture.h).
+    void set_capture_hook(CaptureHook hook, void* context = nullptr) {
+        capture_hook = hook;
+        capture_context = context;
+    }
+
+    // see Decoder::enable_resync()
+    void enable_resync(const bool b = true) { decoder.enable_resync(b); }
+    size_t recovered_count() const { return decoder.recovered_count(); }
+    size_t lost_count() const { return decoder.lost_count(); }
 
     // =============== 0 - System Control ===============
 
-    void local_disable() {
-        auto packet = encoder.local_disable();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId local_disable() {
+        return send<prebuilt::local_disable>();
     }
 
-    void device_type_request() {
-        auto packet = encoder.device_type_request();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId device_type_request() {
+        return send<prebuilt::device_type_request>();
     }
 
-    void local_enable() {
-        auto packet = encoder.local_enable();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId local_enable() {
+        return send<prebuilt::local_enable>();
     }
 
     // =============== 2 - Transport Control ===============
 
-    void stop() {
-        auto packet = encoder.stop();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    // queued like the other commands (see `send()`)
+    CommandId stop() {
+        return send<prebuilt::stop>();
+    }
+    // written at once, bypassing hold, the frame slot and the queue (see `send_now()`)
+    CommandId stop_now() {
+        return send_now<prebuilt::stop>();
     }
 
-    void play() {
-        auto packet = encoder.play();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId play() {
+        return send<prebuilt::play>();
     }
 
-    void record() {
-        auto packet = encoder.record();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId record() {
+        return send<prebuilt::record>();
     }
 
-    void standby_off() {
-        auto packet = encoder.standby_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId standby_off() {
+        return send<prebuilt::standby_off>();
     }
 
-    void standby_on() {
-        auto packet = encoder.standby_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId standby_on() {
+        return send<prebuilt::standby_on>();
     }
 
-    void eject() {
-        auto packet = encoder.eject();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId eject() {
+        return send<prebuilt::eject>();
     }
 
-    void fast_forward() {
-        auto packet = encoder.fast_forward();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId fast_forward() {
+        return send<prebuilt::fast_forward>();
     }
 
-    void jog_forward(const uint8_t data1, const uint8_t data2 = 0) {
+    CommandId jog_forward(const uint8_t data1, const uint8_t data2 = 0) {
         auto packet = encoder.jog_forward(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void var_forward(const uint8_t data1, const uint8_t data2 = 0) {
+    CommandId var_forward(const uint8_t data1, const uint8_t data2 = 0) {
         auto packet = encoder.var_forward(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void shuttle_forward(const uint8_t data1, const uint8_t data2 = 0) {
+    CommandId shuttle_forward(const uint8_t data1, const uint8_t data2 = 0) {
         auto packet = encoder.shuttle_forward(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void frame_step_forward() {
-        auto packet = encoder.frame_step_forward();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId frame_step_forward() {
+        return send<prebuilt::frame_step_forward>();
     }
 
-    void fast_reverse() {
-        auto packet = encoder.fast_reverse();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId fast_reverse() {
+        return send<prebuilt::fast_reverse>();
     }
 
-    void rewind() {
-        auto packet = encoder.rewind();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId rewind() {
+        return send<prebuilt::rewind>();
     }
 
-    void jog_reverse(const uint8_t data1, const uint8_t data2 = 0) {
+    CommandId jog_reverse(const uint8_t data1, const uint8_t data2 = 0) {
         auto packet = encoder.jog_reverse(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void var_reverse(const uint8_t data1, const uint8_t data2 = 0) {
+    CommandId var_reverse(const uint8_t data1, const uint8_t data2 = 0) {
         auto packet = encoder.var_reverse(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void shuttle_reverse(const uint8_t data1, const uint8_t data2 = 0) {
+    CommandId shuttle_reverse(const uint8_t data1, const uint8_t data2 = 0) {
         auto packet = encoder.shuttle_reverse(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void frame_step_reverse() {
-        auto packet = encoder.frame_step_reverse();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId frame_step_reverse() {
+        return send<prebuilt::frame_step_reverse>();
     }
 
-    void preroll() {
-        auto packet = encoder.preroll();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId preroll() {
+        return send<prebuilt::preroll>();
     }
 
-    void cue_up_with_data(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
+    // hh, mm, ss, ff are sent as is (BCD), the TimeCode overload encodes them to BCD
+    CommandId cue_up_with_data(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
         auto packet = encoder.cue_up_with_data(hh, mm, ss, ff);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
+    }
+    CommandId cue_up_with_data(const TimeCode& tc) {
+        auto packet = encoder.cue_up_with_data(tc);
+        return send(packet.data(), packet.size());
     }
 
-    void sync_play() {
-        auto packet = encoder.sync_play();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId sync_play() {
+        return send<prebuilt::sync_play>();
     }
 
-    void prog_speed_play_plus(const uint8_t v) {
+    CommandId prog_speed_play_plus(const uint8_t v) {
         auto packet = encoder.prog_speed_play_plus(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void prog_speed_play_minus(const uint8_t v) {
+    CommandId prog_speed_play_minus(const uint8_t v) {
         auto packet = encoder.prog_speed_play_minus(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void preview() {
-        auto packet = encoder.preview();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId preview() {
+        return send<prebuilt::preview>();
     }
 
-    void review() {
-        auto packet = encoder.review();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId review() {
+        return send<prebuilt::review>();
     }
 
-    void auto_edit() {
-        auto packet = encoder.auto_edit();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId auto_edit() {
+        return send<prebuilt::auto_edit>();
     }
 
-    void outpoint_preview() {
-        auto packet = encoder.outpoint_preview();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId outpoint_preview() {
+        return send<prebuilt::outpoint_preview>();
     }
 
-    void anti_clog_timer_disable() {
+    CommandId anti_clog_timer_disable() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.anti_clog_timer_disable();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void anti_clog_timer_enable() {
+    CommandId anti_clog_timer_enable() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.anti_clog_timer_enable();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void dmc_set_fwd(const uint8_t data1, const uint8_t data2) {
+    CommandId dmc_set_fwd(const uint8_t data1, const uint8_t data2) {
         auto packet = encoder.dmc_set_fwd(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void dmc_set_rev(const uint8_t data1, const uint8_t data2) {
+    CommandId dmc_set_rev(const uint8_t data1, const uint8_t data2) {
         auto packet = encoder.dmc_set_rev(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void full_ee_off() {
-        auto packet = encoder.full_ee_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId full_ee_off() {
+        return send<prebuilt::full_ee_off>();
     }
 
-    void full_ee_on() {
-        auto packet = encoder.full_ee_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId full_ee_on() {
+        return send<prebuilt::full_ee_on>();
     }
 
-    void select_ee_on() {
-        auto packet = encoder.select_ee_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId select_ee_on() {
+        return send<prebuilt::select_ee_on>();
     }
 
-    void edit_off() {
-        auto packet = encoder.edit_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId edit_off() {
+        return send<prebuilt::edit_off>();
     }
 
-    void edit_on() {
-        auto packet = encoder.edit_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId edit_on() {
+        return send<prebuilt::edit_on>();
     }
 
-    void freeze_off() {
-        auto packet = encoder.freeze_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId freeze_off() {
+        return send<prebuilt::freeze_off>();
     }
 
-    void freeze_on() {
-        auto packet = encoder.freeze_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId freeze_on() {
+        return send<prebuilt::freeze_on>();
     }
 
     // =============== 4 - Preset/Select Control ===============
 
-    void timer1_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff, const bool is_df) {
+    CommandId timer1_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff, const bool is_df) {
         auto packet = encoder.timer1_preset(hh, mm, ss, ff, is_df);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
+    }
+    CommandId timer1_preset(const TimeCode& tc) {
+        auto packet = encoder.timer1_preset(tc);
+        return send(packet.data(), packet.size());
     }
 
-    void time_code_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff, const bool is_df) {
+    CommandId time_code_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff, const bool is_df) {
         auto packet = encoder.time_code_preset(hh, mm, ss, ff, is_df);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
+    }
+    CommandId time_code_preset(const TimeCode& tc) {
+        auto packet = encoder.time_code_preset(tc);
+        return send(packet.data(), packet.size());
     }
 
-    void user_bit_preset(const uint8_t data1, const uint8_t data2, const uint8_t data3, const uint8_t data4) {
+    CommandId user_bit_preset(const uint8_t data1, const uint8_t data2, const uint8_t data3, const uint8_t data4) {
         auto packet = encoder.user_bit_preset(data1, data2, data3, data4);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void timer1_reset() {
-        auto packet = encoder.timer1_reset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId timer1_reset() {
+        return send<prebuilt::timer1_reset>();
     }
 
-    void in_entry() {
-        auto packet = encoder.in_entry();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId in_entry() {
+        return send<prebuilt::in_entry>();
     }
 
-    void out_entry() {
-        auto packet = encoder.out_entry();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId out_entry() {
+        return send<prebuilt::out_entry>();
     }
 
-    void audio_in_entry() {
+    CommandId audio_in_entry() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_in_entry();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_out_entry() {
+    CommandId audio_out_entry() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_out_entry();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void in_data_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
+    CommandId in_data_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
         auto packet = encoder.in_data_preset(hh, mm, ss, ff);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
+    }
+    CommandId in_data_preset(const TimeCode& tc) {
+        auto packet = encoder.in_data_preset(tc);
+        return send(packet.data(), packet.size());
     }
 
-    void out_data_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
+    CommandId out_data_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
         auto packet = encoder.out_data_preset(hh, mm, ss, ff);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
+    }
+    CommandId out_data_preset(const TimeCode& tc) {
+        auto packet = encoder.out_data_preset(tc);
+        return send(packet.data(), packet.size());
     }
 
-    void audio_in_data_preset() {
+    CommandId audio_in_data_preset() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_in_data_preset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_out_data_preset() {
+    CommandId audio_out_data_preset() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_out_data_preset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void in_shift_plus() {
-        auto packet = encoder.in_shift_plus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId in_shift_plus() {
+        return send<prebuilt::in_shift_plus>();
     }
 
-    void in_shift_minus() {
-        auto packet = encoder.in_shift_minus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId in_shift_minus() {
+        return send<prebuilt::in_shift_minus>();
     }
 
-    void out_shift_plus() {
-        auto packet = encoder.out_shift_plus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId out_shift_plus() {
+        return send<prebuilt::out_shift_plus>();
     }
 
-    void out_shift_minus() {
-        auto packet = encoder.out_shift_minus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId out_shift_minus() {
+        return send<prebuilt::out_shift_minus>();
     }
 
-    void audio_in_shift_plus() {
-        auto packet = encoder.audio_in_shift_plus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_in_shift_plus() {
+        return send<prebuilt::audio_in_shift_plus>();
     }
 
-    void audio_in_shift_minus() {
-        auto packet = encoder.audio_in_shift_minus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_in_shift_minus() {
+        return send<prebuilt::audio_in_shift_minus>();
     }
 
-    void audio_out_shift_plus() {
-        auto packet = encoder.audio_out_shift_plus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_out_shift_plus() {
+        return send<prebuilt::audio_out_shift_plus>();
     }
 
-    void audio_out_shift_minus() {
-        auto packet = encoder.audio_out_shift_minus();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_out_shift_minus() {
+        return send<prebuilt::audio_out_shift_minus>();
     }
 
-    void in_flag_reset() {
-        auto packet = encoder.in_flag_reset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId in_flag_reset() {
+        return send<prebuilt::in_flag_reset>();
     }
 
-    void out_flag_reset() {
-        auto packet = encoder.out_flag_reset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId out_flag_reset() {
+        return send<prebuilt::out_flag_reset>();
     }
 
-    void audio_in_flag_reset() {
-        auto packet = encoder.audio_in_flag_reset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_in_flag_reset() {
+        return send<prebuilt::audio_in_flag_reset>();
     }
 
-    void audio_out_flag_reset() {
-        auto packet = encoder.audio_out_flag_reset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_out_flag_reset() {
+        return send<prebuilt::audio_out_flag_reset>();
     }
 
-    void in_recall() {
-        auto packet = encoder.in_recall();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId in_recall() {
+        return send<prebuilt::in_recall>();
     }
 
-    void out_recall() {
-        auto packet = encoder.out_recall();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId out_recall() {
+        return send<prebuilt::out_recall>();
     }
 
-    void audio_in_recall() {
-        auto packet = encoder.audio_in_recall();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_in_recall() {
+        return send<prebuilt::audio_in_recall>();
     }
 
-    void audio_out_recall() {
-        auto packet = encoder.audio_out_recall();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_out_recall() {
+        return send<prebuilt::audio_out_recall>();
     }
 
-    void lost_lock_reset() {
-        auto packet = encoder.lost_lock_reset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId lost_lock_reset() {
+        return send<prebuilt::lost_lock_reset>();
     }
 
-    void edit_preset(const uint8_t data1, const uint8_t data2) {
+    CommandId edit_preset(const uint8_t data1, const uint8_t data2) {
         // TODO: more user-friendly arguments?
         auto packet = encoder.edit_preset(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void preroll_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
+    CommandId preroll_preset(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
         auto packet = encoder.preroll_preset(hh, mm, ss, ff);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
+    }
+    CommandId preroll_preset(const TimeCode& tc) {
+        auto packet = encoder.preroll_preset(tc);
+        return send(packet.data(), packet.size());
     }
 
-    void tape_audio_select(const uint8_t v) {
+    CommandId tape_audio_select(const uint8_t v) {
         auto packet = encoder.tape_audio_select(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void servo_ref_select(const uint8_t v) {
+    CommandId servo_ref_select(const uint8_t v) {
         auto packet = encoder.servo_ref_select(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void head_select(const uint8_t v) {
+    CommandId head_select(const uint8_t v) {
         auto packet = encoder.head_select(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void color_frame_select(const uint8_t v) {
+    CommandId color_frame_select(const uint8_t v) {
         auto packet = encoder.color_frame_select(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void timer_mode_select(const TimerMode tm) {
+    CommandId timer_mode_select(const TimerMode tm) {
         auto packet = encoder.timer_mode_select(tm);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void input_check(const uint8_t v) {
+    CommandId input_check(const uint8_t v) {
         auto packet = encoder.input_check(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void edit_field_select(const uint8_t v) {
+    CommandId edit_field_select(const uint8_t v) {
         auto packet = encoder.edit_field_select(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void freeze_mode_select(const uint8_t v) {
+    CommandId freeze_mode_select(const uint8_t v) {
         auto packet = encoder.freeze_mode_select(v);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void record_inhibit() {
+    CommandId record_inhibit() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.record_inhibit();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void auto_mode_off() {
-        auto packet = encoder.auto_mode_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId auto_mode_off() {
+        return send<prebuilt::auto_mode_off>();
     }
 
-    void auto_mode_on() {
-        auto packet = encoder.auto_mode_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId auto_mode_on() {
+        return send<prebuilt::auto_mode_on>();
     }
 
-    void spot_erase_off() {
-        auto packet = encoder.spot_erase_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId spot_erase_off() {
+        return send<prebuilt::spot_erase_off>();
     }
 
-    void spot_erase_on() {
-        auto packet = encoder.spot_erase_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId spot_erase_on() {
+        return send<prebuilt::spot_erase_on>();
     }
 
-    void audio_split_off() {
-        auto packet = encoder.audio_split_off();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_split_off() {
+        return send<prebuilt::audio_split_off>();
     }
 
-    void audio_split_on() {
-        auto packet = encoder.audio_split_on();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_split_on() {
+        return send<prebuilt::audio_split_on>();
     }
 
-    void output_h_phase() {
+    CommandId output_h_phase() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.output_h_phase();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void output_video_phase() {
+    CommandId output_video_phase() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.output_video_phase();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_input_level() {
+    CommandId audio_input_level() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_input_level();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_output_level() {
+    CommandId audio_output_level() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_output_level();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_adv_level() {
+    CommandId audio_adv_level() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_adv_level();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_output_phase() {
+    CommandId audio_output_phase() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_output_phase();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void audio_adv_output_phase() {
+    CommandId audio_adv_output_phase() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.audio_adv_output_phase();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void cross_fade_time_preset() {
+    CommandId cross_fade_time_preset() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.cross_fade_time_preset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void local_key_map() {
+    CommandId local_key_map() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.local_key_map();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void still_off_time(const uint8_t data1, const uint8_t data2) {
+    CommandId still_off_time(const uint8_t data1, const uint8_t data2) {
         // TODO: more user-friendly arguments?
         auto packet = encoder.still_off_time(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void stby_off_time(const uint8_t data1, const uint8_t data2) {
+    CommandId stby_off_time(const uint8_t data1, const uint8_t data2) {
         // TODO: more user-friendly arguments?
         auto packet = encoder.stby_off_time(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
     // =============== 6 - Sense Request ===============
 
-    void tc_gen_sense(const uint8_t data1) {
+    CommandId tc_gen_sense(const uint8_t data1) {
         auto packet = encoder.tc_gen_sense(data1);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
-    void tc_gen_sense_tc() {
-        tc_gen_sense(TcGenData::TC);
+    CommandId tc_gen_sense_tc() {
+        return send<prebuilt::tc_gen_sense_tc>();
     }
-    void tc_gen_sense_ub() {
-        tc_gen_sense(TcGenData::UB);
+    CommandId tc_gen_sense_ub() {
+        return send<prebuilt::tc_gen_sense_ub>();
     }
-    void tc_ub_gen_sense_tc_and_ub() {
-        tc_gen_sense(TcGenData::TC_UB);
+    CommandId tc_ub_gen_sense_tc_and_ub() {
+        return send<prebuilt::tc_ub_gen_sense_tc_and_ub>();
     }
 
-    void current_time_sense(const uint8_t data1) {
+    CommandId current_time_sense(const uint8_t data1) {
         auto packet = encoder.current_time_sense(data1);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
-    void current_time_sense_timer1() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(TIMER_1);
+    CommandId current_time_sense_timer1() {
+        return send<prebuilt::current_time_sense_timer1>();
     }
-    void current_time_sense_timer2() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(TIMER_2);
+    CommandId current_time_sense_timer2() {
+        return send<prebuilt::current_time_sense_timer2>();
     }
-    void current_time_sense_ltc_tc_ub() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(LTC_UB | LTC_TC);
+    CommandId current_time_sense_ltc_tc_ub() {
+        return send<prebuilt::current_time_sense_ltc_tc_ub>();
     }
-    void current_time_sense_ltc_tc() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(LTC_TC);
+    CommandId current_time_sense_ltc_tc() {
+        return send<prebuilt::current_time_sense_ltc_tc>();
     }
-    void current_time_sense_ltc_ub() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(LTC_UB);
+    CommandId current_time_sense_ltc_ub() {
+        return send<prebuilt::current_time_sense_ltc_ub>();
     }
-    void current_time_sense_vitc_tc_ub() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(VITC_UB | VITC_TC);
+    CommandId current_time_sense_vitc_tc_ub() {
+        return send<prebuilt::current_time_sense_vitc_tc_ub>();
     }
-    void current_time_sense_vitc_tc() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(VITC_TC);
+    CommandId current_time_sense_vitc_tc() {
+        return send<prebuilt::current_time_sense_vitc_tc>();
     }
-    void current_time_sense_vitc_ub() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(VITC_UB);
+    CommandId current_time_sense_vitc_ub() {
+        return send<prebuilt::current_time_sense_vitc_ub>();
     }
     // TODO: should confirm if ltc interpolated flag, currently same as LTC
-    void current_time_sense_ltc_interpolated_tc_ub() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(LTC_UB | LTC_TC);
+    CommandId current_time_sense_ltc_interpolated_tc_ub() {
+        return send<prebuilt::current_time_sense_ltc_tc_ub>();
     }
-    void current_time_sense_ltc_interpolated_tc() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(LTC_TC);
+    CommandId current_time_sense_ltc_interpolated_tc() {
+        return send<prebuilt::current_time_sense_ltc_tc>();
     }
-    void current_time_sense_ltc_interpolated_ub() {
-        using namespace CurrentTimeSenseFlag;
-        current_time_sense(LTC_UB);
+    CommandId current_time_sense_ltc_interpolated_ub() {
+        return send<prebuilt::current_time_sense_ltc_ub>();
     }
 
-    void in_data_sense() {
-        auto packet = encoder.in_data_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId in_data_sense() {
+        return send<prebuilt::in_data_sense>();
     }
 
-    void out_data_sense() {
-        auto packet = encoder.out_data_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId out_data_sense() {
+        return send<prebuilt::out_data_sense>();
     }
 
-    void audio_in_data_sense() {
-        auto packet = encoder.audio_in_data_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_in_data_sense() {
+        return send<prebuilt::audio_in_data_sense>();
     }
 
-    void audio_out_data_sense() {
-        auto packet = encoder.audio_out_data_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId audio_out_data_sense() {
+        return send<prebuilt::audio_out_data_sense>();
     }
 
-    void status_sense(const uint8_t start = 0, const uint8_t size = 10) {
+    CommandId status_sense(const uint8_t start = 0, const uint8_t size = 10) {
         status_start = start;
         status_size = size;
+        if (start == 0 && size == 10)
+            return send<prebuilt::status_sense>();
         auto packet = encoder.status_sense(start, size);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void extended_vtr_status(const uint8_t data1) {
+    CommandId extended_vtr_status(const uint8_t data1) {
         auto packet = encoder.extended_vtr_status(data1);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void signal_control_sense(const uint8_t data1, const uint8_t data2) {
+    CommandId signal_control_sense(const uint8_t data1, const uint8_t data2) {
         auto packet = encoder.signal_control_sense(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void local_keymap_sense() {
+    CommandId local_keymap_sense() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.local_keymap_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void head_meter_sense(const uint8_t data1) {
+    CommandId head_meter_sense(const uint8_t data1) {
         auto packet = encoder.head_meter_sense(data1);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void remaining_time_sense() {
-        auto packet = encoder.remaining_time_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId remaining_time_sense() {
+        return send<prebuilt::remaining_time_sense>();
     }
 
-    void cmd_speed_sense() {
-        auto packet = encoder.cmd_speed_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId cmd_speed_sense() {
+        return send<prebuilt::cmd_speed_sense>();
     }
 
-    void edit_preset_sense(const uint8_t data1) {
+    CommandId edit_preset_sense(const uint8_t data1) {
         auto packet = encoder.edit_preset_sense(data1);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void preroll_time_sense() {
-        auto packet = encoder.preroll_time_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId preroll_time_sense() {
+        return send<prebuilt::preroll_time_sense>();
     }
 
-    void timer_mode_sense() {
-        auto packet = encoder.timer_mode_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId timer_mode_sense() {
+        return send<prebuilt::timer_mode_sense>();
     }
 
-    void record_inhibit_sense() {
-        auto packet = encoder.record_inhibit_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId record_inhibit_sense() {
+        return send<prebuilt::record_inhibit_sense>();
     }
 
-    void da_inp_emph_sense() {
-        auto packet = encoder.da_inp_emph_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId da_inp_emph_sense() {
+        return send<prebuilt::da_inp_emph_sense>();
     }
 
-    void da_pb_emph_sense() {
-        auto packet = encoder.da_pb_emph_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId da_pb_emph_sense() {
+        return send<prebuilt::da_pb_emph_sense>();
     }
 
-    void da_samp_freq_sense() {
-        auto packet = encoder.da_samp_freq_sense();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId da_samp_freq_sense() {
+        return send<prebuilt::da_samp_freq_sense>();
     }
 
-    void cross_fade_time_sense(const uint8_t data1) {
+    CommandId cross_fade_time_sense(const uint8_t data1) {
         auto packet = encoder.cross_fade_time_sense(data1);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
     // =============== A - BlackMagic Advanced Media Protocol ===============
 
-    void bmd_seek_to_timeline_pos(const uint8_t data1, const uint8_t data2) {
+    CommandId bmd_seek_to_timeline_pos(const uint8_t data1, const uint8_t data2) {
         // TODO: more user-friendly arguments?
         auto packet = encoder.bmd_seek_to_timeline_pos(data1, data2);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void clear_playlist() {
-        auto packet = encoder.clear_playlist();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+    CommandId clear_playlist() {
+        return send<prebuilt::clear_playlist>();
     }
 
-    void append_preset() {
+    CommandId append_preset() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.append_preset();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void set_playback_loop(const bool b_enable, const uint8_t mode = LoopMode::SINGLE_CLIP) {
+    CommandId set_playback_loop(const bool b_enable, const uint8_t mode = LoopMode::SINGLE_CLIP) {
         auto packet = encoder.set_playback_loop(b_enable, mode);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void set_stop_mode(const uint8_t stop_mode) {
+    CommandId set_stop_mode(const uint8_t stop_mode) {
         auto packet = encoder.set_stop_mode(stop_mode);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void bmd_seek_relative_clip(const int8_t index) {
+    CommandId bmd_seek_relative_clip(const int8_t index) {
         auto packet = encoder.bmd_seek_relative_clip(index);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void auto_skip(const int8_t n) {
+    CommandId auto_skip(const int8_t n) {
         auto packet = encoder.auto_skip(n);
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
-    void list_next_id() {
+    CommandId list_next_id() {
         // TODO: NOT IMPLEMENTED
         auto packet = encoder.list_next_id();
-        SONY9PINREMOTE_STREAM_WRITE(packet.data(), packet.size());
+        return send(packet.data(), packet.size());
     }
 
     // =============== 1 - System Control Return ===============
@@ -959,74 +1229,74 @@ public:
     // =============== Status Checker ===============
 
     // byte 0
-    bool is_media_exist() const { return !sts.b_cassette_out; }           // set if no ssd is present
-    bool is_servo_ref_exist() const { return !sts.b_servo_ref_missing; }  // set if servo reference is absent
-    bool is_remote_enabled() const { return !sts.b_local; }               // set if remote is disabled (local control)
+    bool is_media_exist() const { return !sts.cassette_out(); }           // set if no ssd is present
+    bool is_servo_ref_exist() const { return !sts.servo_ref_missing(); }  // set if servo reference is absent
+    bool is_remote_enabled() const { return !sts.local(); }               // set if remote is disabled (local control)
     // byte 1
-    bool is_disk_available() const { return sts.b_standby; }  // set if a disk is available
-    bool is_stopping() const { return sts.b_stop; }           // When the machine is in full stop, this is 1. The thread state depends on the tape/ee and standby settings.
-    bool is_ejecting() const { return sts.b_eject; }          // When the tape is ejecting this is 1.
-    bool is_fast_reverse() const { return sts.b_rewind; }     // When the machine is in fast reverse this is 1.
-    bool is_fast_forward() const { return sts.b_forward; }    // When the machine is in fast forward this is 1.
-    bool is_recoding() const { return sts.b_record; }         // This bit goes from 0 to 1 some number of frames after the machine starts recording. For the DVR2000 we measured 5 frames. Others have varying delays on the record status.
-    bool is_playing() const { return sts.b_play; }            // This bit goes from 0 to 1 some number of frames after the machine starts playing. For the DVR2000 we measured 5 frames. Others have varying delays on the play status.
+    bool is_disk_available() const { return sts.standby(); }  // set if a disk is available
+    bool is_stopping() const { return sts.stop(); }           // When the machine is in full stop, this is 1. The thread state depends on the tape/ee and standby settings.
+    bool is_ejecting() const { return sts.eject(); }          // When the tape is ejecting this is 1.
+    bool is_fast_reverse() const { return sts.rewind(); }     // When the machine is in fast reverse this is 1.
+    bool is_fast_forward() const { return sts.forward(); }    // When the machine is in fast forward this is 1.
+    bool is_recoding() const { return sts.record(); }         // This bit goes from 0 to 1 some number of frames after the machine starts recording. For the DVR2000 we measured 5 frames. Others have varying delays on the record status.
+    bool is_playing() const { return sts.play(); }            // This bit goes from 0 to 1 some number of frames after the machine starts playing. For the DVR2000 we measured 5 frames. Others have varying delays on the play status.
     // byte 2
-    bool is_servo_locked() const { return sts.b_servo_lock; }  // 1 indicates servos are locked. This is a necessary condition for an edit to occur correctly.
-    bool is_tso_mode() const { return sts.b_tso_mode; }        // Bit is 1 in tape speed override: in this mode, audio and video are still locked though speed is off play speed by +/- up to 15%.
-    bool is_shuttle() const { return sts.b_shuttle; }
-    bool is_jog() const { return sts.b_jog; }
-    bool is_var() const { return sts.b_var; }
-    bool is_reverse() const { return sts.b_direction; }  // clear if playback is forwarding, set if playback is reversing
-    bool is_paused() const { return sts.b_still; }       // set if playback is paused, or if in input preview mode
-    bool is_cue_up() const { return sts.b_cue_up; }
+    bool is_servo_locked() const { return sts.servo_lock(); }  // 1 indicates servos are locked. This is a necessary condition for an edit to occur correctly.
+    bool is_tso_mode() const { return sts.tso_mode(); }        // Bit is 1 in tape speed override: in this mode, audio and video are still locked though speed is off play speed by +/- up to 15%.
+    bool is_shuttle() const { return sts.shuttle(); }
+    bool is_jog() const { return sts.jog(); }
+    bool is_var() const { return sts.var(); }
+    bool is_reverse() const { return sts.direction(); }  // clear if playback is forwarding, set if playback is reversing
+    bool is_paused() const { return sts.still(); }       // set if playback is paused, or if in input preview mode
+    bool is_cue_up() const { return sts.cue_up(); }
     // byte 3
-    bool is_auto_mode() const { return sts.b_auto_mode; }  // set if in Auto Mode
-    bool is_freezing() const { return sts.b_freeze_on; }
-    bool is_cf_mode() const { return sts.b_cf_mode; }
-    bool is_audio_out_set() const { return sts.b_audio_out_set; }
-    bool is_audio_in_set() const { return sts.b_audio_in_set; }
-    bool is_out_set() const { return sts.b_out_set; }
-    bool is_in_set() const { return sts.b_in_set; }
+    bool is_auto_mode() const { return sts.auto_mode(); }  // set if in Auto Mode
+    bool is_freezing() const { return sts.freeze_on(); }
+    bool is_cf_mode() const { return sts.cf_mode(); }
+    bool is_audio_out_set() const { return sts.audio_out_set(); }
+    bool is_audio_in_set() const { return sts.audio_in_set(); }
+    bool is_out_set() const { return sts.out_set(); }
+    bool is_in_set() const { return sts.in_set(); }
     // byte 4
-    bool is_select_ee() const { return sts.b_select_ee; }  // set if in input preview mode
-    bool is_full_ee() const { return sts.b_full_ee; }
-    bool is_edit() const { return sts.b_edit; }
-    bool is_review() const { return sts.b_review; }
-    bool is_auto_edit() const { return sts.b_auto_edit; }
-    bool is_preview() const { return sts.b_preview; }
-    bool is_preroll() const { return sts.b_preroll; }
+    bool is_select_ee() const { return sts.select_ee(); }  // set if in input preview mode
+    bool is_full_ee() const { return sts.full_ee(); }
+    bool is_edit() const { return sts.edit(); }
+    bool is_review() const { return sts.review(); }
+    bool is_auto_edit() const { return sts.auto_edit(); }
+    bool is_preview() const { return sts.preview(); }
+    bool is_preroll() const { return sts.preroll(); }
     // byte 5
-    bool is_insert() const { return sts.b_insert; }
-    bool is_assemble() const { return sts.b_assemble; }
-    bool is_video() const { return sts.b_video; }
-    bool is_a4() const { return sts.b_a4; }
-    bool is_a3() const { return sts.b_a3; }
-    bool is_a2() const { return sts.b_a2; }
-    bool is_a1() const { return sts.b_a1; }
+    bool is_insert() const { return sts.insert(); }
+    bool is_assemble() const { return sts.assemble(); }
+    bool is_video() const { return sts.video(); }
+    bool is_a4() const { return sts.a4(); }
+    bool is_a3() const { return sts.a3(); }
+    bool is_a2() const { return sts.a2(); }
+    bool is_a1() const { return sts.a1(); }
     // byte 6
-    bool is_lamp_still() const { return sts.b_lamp_still; }  // set according to playback speed and direction
-    bool is_lamp_fwd() const { return sts.b_lamp_fwd; }
-    bool is_lamp_rev() const { return sts.b_lamp_rev; }
-    bool is_srch_led_8() const { return sts.b_srch_led_8; }
-    bool is_srch_led_4() const { return sts.b_srch_led_4; }
-    bool is_srch_led_2() const { return sts.b_srch_led_2; }
-    bool is_srch_led_1() const { return sts.b_srch_led_1; }
+    bool is_lamp_still() const { return sts.lamp_still(); }  // set according to playback speed and direction
+    bool is_lamp_fwd() const { return sts.lamp_fwd(); }
+    bool is_lamp_rev() const { return sts.lamp_rev(); }
+    bool is_srch_led_8() const { return sts.srch_led_8(); }
+    bool is_srch_led_4() const { return sts.srch_led_4(); }
+    bool is_srch_led_2() const { return sts.srch_led_2(); }
+    bool is_srch_led_1() const { return sts.srch_led_1(); }
     // byte 7
-    bool is_aud_split() const { return sts.b_aud_split; }
-    bool is_syn_act() const { return sts.b_sync_act; }
-    bool is_spot_erase() const { return sts.b_spot_erase; }
-    bool is_in_out() const { return sts.b_in_out; }
+    bool is_aud_split() const { return sts.aud_split(); }
+    bool is_syn_act() const { return sts.sync_act(); }
+    bool is_spot_erase() const { return sts.spot_erase(); }
+    bool is_in_out() const { return sts.in_out(); }
     // byte 8
-    bool is_buzzer() const { return sts.b_buzzer; }
-    bool is_lost_lock() const { return sts.b_lost_lock; }
-    bool is_near_eot() const { return sts.b_near_eot; }  // set if total space left on available SSDs is less than 3 minutes
-    bool is_eot() const { return sts.b_eot; }            // set if total space left on available SSDs is less than 30 seconds
-    bool is_cf_lock() const { return sts.b_cf_lock; }
-    bool is_svo_alarm() const { return sts.b_svo_alarm; }
-    bool is_sys_alarm() const { return sts.b_sys_alarm; }
-    bool is_rec_inhib() const { return sts.b_rec_inhib; }
+    bool is_buzzer() const { return sts.buzzer(); }
+    bool is_lost_lock() const { return sts.lost_lock(); }
+    bool is_near_eot() const { return sts.near_eot(); }  // set if total space left on available SSDs is less than 3 minutes
+    bool is_eot() const { return sts.eot(); }            // set if total space left on available SSDs is less than 30 seconds
+    bool is_cf_lock() const { return sts.cf_lock(); }
+    bool is_svo_alarm() const { return sts.svo_alarm(); }
+    bool is_sys_alarm() const { return sts.sys_alarm(); }
+    bool is_rec_inhib() const { return sts.rec_inhib(); }
     // byte 9
-    bool is_fnc_abort() const { return sts.b_fnc_abort; }
+    bool is_fnc_abort() const { return sts.fnc_abort(); }
 
     // =============== Utilities ===============
 
@@ -1044,74 +1314,74 @@ public:
         PRINTLN("<Remote Status>");
         PRINTLN("==================");
         PRINTLN("------byte 0------");
-        PRINTLN("Cassette Out : ", sts.b_cassette_out);
-        PRINTLN("Servo Ref Mis: ", sts.b_servo_ref_missing);
-        PRINTLN("Local        : ", sts.b_local);
+        PRINTLN("Cassette Out : ", sts.cassette_out());
+        PRINTLN("Servo Ref Mis: ", sts.servo_ref_missing());
+        PRINTLN("Local        : ", sts.local());
         PRINTLN("------byte 1------");
-        PRINTLN("Standby      : ", sts.b_standby);
-        PRINTLN("Stop         : ", sts.b_stop);
-        PRINTLN("Eject        : ", sts.b_eject);
-        PRINTLN("Rewind       : ", sts.b_rewind);
-        PRINTLN("Forward      : ", sts.b_forward);
-        PRINTLN("Record       : ", sts.b_record);
-        PRINTLN("Play         : ", sts.b_play);
+        PRINTLN("Standby      : ", sts.standby());
+        PRINTLN("Stop         : ", sts.stop());
+        PRINTLN("Eject        : ", sts.eject());
+        PRINTLN("Rewind       : ", sts.rewind());
+        PRINTLN("Forward      : ", sts.forward());
+        PRINTLN("Record       : ", sts.record());
+        PRINTLN("Play         : ", sts.play());
         PRINTLN("------byte 2------");
-        PRINTLN("Servo Lock   : ", sts.b_servo_lock);
-        PRINTLN("TSO Mode     : ", sts.b_tso_mode);
-        PRINTLN("Shuttle      : ", sts.b_shuttle);
-        PRINTLN("Jog          : ", sts.b_jog);
-        PRINTLN("Var          : ", sts.b_var);
-        PRINTLN("Direction    : ", sts.b_direction);
-        PRINTLN("Still        : ", sts.b_still);
-        PRINTLN("Cue Up       : ", sts.b_cue_up);
+        PRINTLN("Servo Lock   : ", sts.servo_lock());
+        PRINTLN("TSO Mode     : ", sts.tso_mode());
+        PRINTLN("Shuttle      : ", sts.shuttle());
+        PRINTLN("Jog          : ", sts.jog());
+        PRINTLN("Var          : ", sts.var());
+        PRINTLN("Direction    : ", sts.direction());
+        PRINTLN("Still        : ", sts.still());
+        PRINTLN("Cue Up       : ", sts.cue_up());
         PRINTLN("------byte 3------");
-        PRINTLN("Auto Mode    : ", sts.b_auto_mode);
-        PRINTLN("Freeze On    : ", sts.b_freeze_on);
-        PRINTLN("CF Mode      : ", sts.b_cf_mode);
-        PRINTLN("Audio Out Set: ", sts.b_audio_out_set);
-        PRINTLN("Audio In Set : ", sts.b_audio_in_set);
-        PRINTLN("Out Set      : ", sts.b_out_set);
-        PRINTLN("In Set       : ", sts.b_in_set);
+        PRINTLN("Auto Mode    : ", sts.auto_mode());
+        PRINTLN("Freeze On    : ", sts.freeze_on());
+        PRINTLN("CF Mode      : ", sts.cf_mode());
+        PRINTLN("Audio Out Set: ", sts.audio_out_set());
+        PRINTLN("Audio In Set : ", sts.audio_in_set());
+        PRINTLN("Out Set      : ", sts.out_set());
+        PRINTLN("In Set       : ", sts.in_set());
         PRINTLN("------byte 4------");
-        PRINTLN("Select EE    : ", sts.b_select_ee);
-        PRINTLN("Full EE      : ", sts.b_full_ee);
-        PRINTLN("Edit         : ", sts.b_edit);
-        PRINTLN("Review       : ", sts.b_review);
-        PRINTLN("Auto Edit    : ", sts.b_auto_edit);
-        PRINTLN("Preview      : ", sts.b_preview);
-        PRINTLN("Preroll      : ", sts.b_preroll);
+        PRINTLN("Select EE    : ", sts.select_ee());
+        PRINTLN("Full EE      : ", sts.full_ee());
+        PRINTLN("Edit         : ", sts.edit());
+        PRINTLN("Review       : ", sts.review());
+        PRINTLN("Auto Edit    : ", sts.auto_edit());
+        PRINTLN("Preview      : ", sts.preview());
+        PRINTLN("Preroll      : ", sts.preroll());
         PRINTLN("------byte 5------");
-        PRINTLN("Insert       : ", sts.b_insert);
-        PRINTLN("Assemble     : ", sts.b_assemble);
-        PRINTLN("Video        : ", sts.b_video);
-        PRINTLN("A4           : ", sts.b_a4);
-        PRINTLN("A3           : ", sts.b_a3);
-        PRINTLN("A2           : ", sts.b_a2);
-        PRINTLN("A1           : ", sts.b_a1);
+        PRINTLN("Insert       : ", sts.insert());
+        PRINTLN("Assemble     : ", sts.assemble());
+        PRINTLN("Video        : ", sts.video());
+        PRINTLN("A4           : ", sts.a4());
+        PRINTLN("A3           : ", sts.a3());
+        PRINTLN("A2           : ", sts.a2());
+        PRINTLN("A1           : ", sts.a1());
         PRINTLN("------byte 6------");
-        PRINTLN("Lamp Still   : ", sts.b_lamp_still);
-        PRINTLN("Lamp Fwd     : ", sts.b_lamp_fwd);
-        PRINTLN("Lamp Rev     : ", sts.b_lamp_rev);
-        PRINTLN("SRCH Led 8   : ", sts.b_srch_led_8);
-        PRINTLN("SRCH Led 4   : ", sts.b_srch_led_4);
-        PRINTLN("SRCH Led 2   : ", sts.b_srch_led_2);
-        PRINTLN("SRCH Led 1   : ", sts.b_srch_led_1);
+        PRINTLN("Lamp Still   : ", sts.lamp_still());
+        PRINTLN("Lamp Fwd     : ", sts.lamp_fwd());
+        PRINTLN("Lamp Rev     : ", sts.lamp_rev());
+        PRINTLN("SRCH Led 8   : ", sts.srch_led_8());
+        PRINTLN("SRCH Led 4   : ", sts.srch_led_4());
+        PRINTLN("SRCH Led 2   : ", sts.srch_led_2());
+        PRINTLN("SRCH Led 1   : ", sts.srch_led_1());
         PRINTLN("------byte 7------");
-        PRINTLN("AUD Split    : ", sts.b_aud_split);
-        PRINTLN("Sync Act     : ", sts.b_sync_act);
-        PRINTLN("Spot Erase   : ", sts.b_spot_erase);
-        PRINTLN("In Out       : ", sts.b_in_out);
+        PRINTLN("AUD Split    : ", sts.aud_split());
+        PRINTLN("Sync Act     : ", sts.sync_act());
+        PRINTLN("Spot Erase   : ", sts.spot_erase());
+        PRINTLN("In Out       : ", sts.in_out());
         PRINTLN("------byte 8------");
-        PRINTLN("Buzzer       : ", sts.b_buzzer);
-        PRINTLN("Lost Lock    : ", sts.b_lost_lock);
-        PRINTLN("Near EOT     : ", sts.b_near_eot);
-        PRINTLN("EOT          : ", sts.b_eot);
-        PRINTLN("CF Lock      : ", sts.b_cf_lock);
-        PRINTLN("SVO Alarm    : ", sts.b_svo_alarm);
-        PRINTLN("Sys Alarm    : ", sts.b_sys_alarm);
-        PRINTLN("Rec Inhibit  : ", sts.b_rec_inhib);
+        PRINTLN("Buzzer       : ", sts.buzzer());
+        PRINTLN("Lost Lock    : ", sts.lost_lock());
+        PRINTLN("Near EOT     : ", sts.near_eot());
+        PRINTLN("EOT          : ", sts.eot());
+        PRINTLN("CF Lock      : ", sts.cf_lock());
+        PRINTLN("SVO Alarm    : ", sts.svo_alarm());
+        PRINTLN("Sys Alarm    : ", sts.sys_alarm());
+        PRINTLN("Rec Inhibit  : ", sts.rec_inhib());
         PRINTLN("------byte 9------");
-        PRINTLN("FNC Abort    : ", sts.b_fnc_abort);
+        PRINTLN("FNC Abort    : ", sts.fnc_abort());
         PRINTLN("==================");
     }
 
@@ -1144,6 +1414,239 @@ public:
     void print_preroll_time() const { print_timecode(preroll_time()); }
 
 private:
+    // read as many bytes as possible into the free contiguous space of the receive buffer
+    size_t receive() {
+        const size_t size = SONY9PINREMOTE_STREAM_AVAILABLE();
+        if (size == 0) return 0;
+        const size_t idx = rx_tail & RX_BUFFER_MASK;
+        const size_t space = RX_BUFFER_SIZE - (rx_tail - rx_head);
+        const size_t contiguous = RX_BUFFER_SIZE - idx;
+        size_t n = (size < space) ? size : space;
+        n = (n < contiguous) ? n : contiguous;
+        if (n == 0) return 0;
+        const long received = (long)SONY9PINREMOTE_STREAM_READ(rx_buffer + idx, n);
+        if (received <= 0) return 0;
+        if (capture_hook) capture_hook(CaptureDirection::RX, rx_buffer + idx, (size_t)received, Clock::micros(), capture_context);
+        rx_tail += (size_t)received;
+        return (size_t)received;
+    }
+
+    // store the data which is useful if it can be referred anytime we want
+    void on_reply() {
+        // only one command is sent at a time, so the reply belongs to the one in flight unless it does not match (e.g. stale)
+        CommandRecord* r = queue.front();
+        if (r && r->status != CommandStatus::SENT) r = nullptr;
+        // the device may drop the reply of the one in flight when the next one is written by send_now()
+        CommandRecord* next = queue.at(1);
+        if (r && !is_expected_reply(*r, decoder) && next && next->status == CommandStatus::SENT && is_expected_reply(*next, decoder)) {
+            LOG_WARN("no reply: cmd1", DebugLogBase::HEX, (uint8_t)r->cmd1(), "cmd2", r->cmd2());
+            r->status = CommandStatus::TIMEOUT;
+            latency_histograms.add_timeout(r->cmd1(), r->cmd2());
+            queue.pop();
+            r = next;
+        }
+        const bool b_unexpected = r && !is_expected_reply(*r, decoder);
+        if (b_unexpected) {
+            LOG_WARN("unexpected reply: cmd1", DebugLogBase::HEX, (uint8_t)decoder.cmd1(), "cmd2", decoder.cmd2(), "to", (uint8_t)r->cmd1(), r->cmd2());
+            ++unexpected_replies;
+            r = nullptr;
+        }
+        if (r) {
+            r->replied_us = Clock::micros();
+            latency_histograms.add(r->cmd1(), r->cmd2(), r->replied_us - r->sent_us);
+            if (decoder.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && decoder.cmd2() == SystemControlReturn::ACK)
+                r->status = CommandStatus::ACK;
+            else if (decoder.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && decoder.cmd2() == SystemControlReturn::NAK)
+                r->status = CommandStatus::NAK;
+            else
+                r->status = CommandStatus::REPLY;
+            r->reply_cmd1 = decoder.cmd1();
+            r->reply_cmd2 = decoder.cmd2();
+            r->reply_size = decoder.size();
+            if (r->reply_size > 0) memcpy(r->reply, decoder.data(), r->reply_size);
+        }
+
+        switch (decoder.cmd1()) {
+            case Cmd1::SYSTEM_CONTROL_RETURN: {
+                switch (decoder.cmd2()) {
+                    case SystemControlReturn::NAK: {
+                        err_count++;
+                        err = decoder.nak();
+                        if (r) r->errors = err;
+                        break;
+                    }
+                    case SystemControlReturn::DEVICE_TYPE: {
+                        dev_type = decoder.device_type();
+                        break;
+                    }
+                }
+                break;
+            }
+            case Cmd1::SENSE_RETURN: {
+                if (decoder.cmd2() != SenseReturn::STATUS_DATA)
+                    sense_returns.store(decoder.cmd2(), decoder.data(), decoder.size(), r ? r->replied_us : Clock::micros());
+                if (decoder.cmd2() == SenseReturn::STATUS_DATA) {
+                    // decode status based on requested range by `status_sense()`
+                    if (r && r->cmd1() == Cmd1::SENSE_REQUEST && r->cmd2() == SenseRequest::STATUS_SENSE)
+                        update_status(r->packet[2] >> 4, r->packet[2] & 0x0F);
+                    else
+                        update_status(status_start, status_size);
+                } else if (is_current_time_reply(decoder.cmd2())) {
+                    // anchor at the middle of the round trip if the request is known
+                    const uint32_t now = r ? r->replied_us : Clock::micros();
+                    const uint32_t at = (r ? now - (now - r->sent_us) / 2 : now) - tc_latency_us;
+                    predictor.anchor(decoder.timecode(), at, sts, decoder.cmd2());
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        if (b_unexpected) return;  // still waiting for the reply of the command in flight
+        if (r) queue.pop();
+        b_wait_for_response = in_flight();  // a command written by send_now() may follow
+        dispatch();
+    }
+
+    template <typename Handlers>
+    void dispatch_reply(Handlers& handlers) const {
+        handlers.on_packet(decoder);
+        switch (decoder.cmd1()) {
+            case Cmd1::SYSTEM_CONTROL_RETURN: {
+                switch (decoder.cmd2()) {
+                    case SystemControlReturn::ACK: handlers.on_ack(); break;
+                    case SystemControlReturn::NAK: handlers.on_nak(err); break;
+                    case SystemControlReturn::DEVICE_TYPE: handlers.on_device_type(dev_type); break;
+                }
+                break;
+            }
+            case Cmd1::SENSE_RETURN: {
+                if (decoder.cmd2() == SenseReturn::STATUS_DATA)
+                    handlers.on_status(sts.to_status());
+                else if (decoder.size() >= TIMECODE_SIZE && reply_info((uint8_t)Cmd1::SENSE_RETURN, decoder.cmd2()).timecode())
+                    handlers.on_timecode(decoder.cmd2(), decoder.timecode());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Only the requested range is updated, so that the bytes out of range do not fire events.
+    void update_status(const uint8_t start, const uint8_t size) {
+        const RawStatus curr = decoder.raw_status_sense(start, size);
+        RawStatus next = sts;
+        for (uint8_t i = start; (i < start + size) && (i < RawStatus::SIZE); ++i)
+            next.bytes[i] = curr.bytes[i];
+        if (next == sts) return;
+
+        const uint32_t now = Clock::micros();
+        RawStatus diff;
+        for (uint8_t i = 0; i < RawStatus::SIZE; ++i)
+            diff.bytes[i] = sts.bytes[i] ^ next.bytes[i];
+#define SONY9PIN_STATUS_DIFF(byte, mask, name) \
+    if (diff.name()) push_status_event(StatusBit::mask, next.name(), now);
+        SONY9PIN_STATUS_BITS(SONY9PIN_STATUS_DIFF)
+#undef SONY9PIN_STATUS_DIFF
+        sts = next;
+    }
+
+    void push_status_event(const StatusBit bit, const bool value, const uint32_t timestamp) {
+        if (status_event_count == SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE) {
+            // drop the oldest one
+            status_event_head = (status_event_head + 1) % SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE;
+            --status_event_count;
+            ++status_event_lost;
+        }
+        StatusEvent& e = status_events[(status_event_head + status_event_count) % SONY9PINREMOTE_STATUS_EVENT_QUEUE_SIZE];
+        e.bit = bit;
+        e.value = value;
+        e.timestamp = timestamp;
+        ++status_event_count;
+    }
+
+    static bool is_current_time_reply(const uint8_t cmd2) {
+        switch (cmd2) {
+            case SenseReturn::TIMER_1:
+            case SenseReturn::TIMER_2:
+            case SenseReturn::LTC_TC_UB:
+            case SenseReturn::VITC_TC_UB:
+            case SenseReturn::LTC_INTERPOLATED_TC_UB:
+            case SenseReturn::HOLD_VITC_TC_UB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static ReplyType expected_reply(const uint8_t* data) {
+        const CommandInfo info = command_info(data[0], data[1]);
+        if (info.known())
+            return info.reply;
+        // unknown sense requests (e.g. vendor extensions) still return a sense reply
+        const Cmd1 cmd1 = (Cmd1)(data[0] & (uint8_t)HeaderMask::CMD1);
+        return (cmd1 == Cmd1::SENSE_REQUEST) ? ReplyType::SENSE : ReplyType::ACK;
+    }
+
+    // the reply should be NAK or the one in the command table
+    static bool is_expected_reply(const CommandRecord& r, const Decoder& d) {
+        if (d.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && d.cmd2() == SystemControlReturn::NAK) return true;
+        const CommandInfo info = command_info(r.packet[0], r.packet[1]);
+        if (!info.known()) return true;
+        switch (info.reply) {
+            case ReplyType::ACK: return d.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && d.cmd2() == SystemControlReturn::ACK;
+            case ReplyType::DEVICE_TYPE: return d.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && d.cmd2() == SystemControlReturn::DEVICE_TYPE;
+            case ReplyType::SENSE:
+                if (d.cmd1() != Cmd1::SENSE_RETURN) return false;
+                if (info.reply_cmd2 != VARIABLE_REPLY && d.cmd2() != info.reply_cmd2) return false;
+                return info.reply_size == VARIABLE_SIZE || d.size() == info.reply_size;
+        }
+        return true;
+    }
+
+    // the oldest pending command has been written and is waiting for the reply
+    bool in_flight() const {
+        const CommandRecord* r = queue.front();
+        return r && r->status == CommandStatus::SENT;
+    }
+
+    // write the oldest queued command if no command is in flight and its frame slot has come
+    // Write to the stream and capture only the bytes which have been actually written,
+    // so that a short or failed write is not recorded as if the whole packet went out.
+    // SONY9PINREMOTE_STREAM_WRITE returns the written size (negative on error with openFrameworks).
+    size_t write(const uint8_t* data, const size_t size, const uint32_t now) {
+        const int64_t n = (int64_t)(SONY9PINREMOTE_STREAM_WRITE(data, size));
+        const size_t written = (n > 0) ? (size_t)n : 0;
+        if (written < size) LOG_ERROR("Writing to serial FAILED:", written, "of", size, "bytes written");
+        if (capture_hook && written) capture_hook(CaptureDirection::TX, data, written, now, capture_context);
+        return written;
+    }
+
+    void dispatch() {
+        if (b_hold || (b_wait_for_response && !b_force_send)) return;
+        CommandRecord* r = queue.front();
+        if (!r || r->status != CommandStatus::QUEUED) return;
+
+        const uint32_t now = Clock::micros();
+        const uint32_t interval = frame_interval_us(frame_rate);
+        if (interval > 0) {
+            if ((int32_t)(now - next_slot_us) < 0) return;
+            // keep the slots on the frame grid unless the link has been idle for a while
+            next_slot_us = ((uint32_t)(now - next_slot_us) < interval) ? next_slot_us + interval : now + interval;
+        }
+
+        write(r->packet, r->size, now);
+        r->status = CommandStatus::SENT;
+        r->sent_us = now;
+        r->deadline_us = now + reply_timeout_us;
+        delay_stats.add(now - r->queued_us);
+        if (b_force_send)
+            queue.pop();  // replies are not correlated in force_send mode
+        else
+            b_wait_for_response = true;
+    }
+
     void print_timecode_userbits(const TimeCodeAndUserBits& tcub) const {
         print_timecode(tcub.tc);
         print_userbits(tcub.ub);
@@ -1158,6 +1661,8 @@ private:
     }
 };
 
+using Controller = BasicController<DefaultClock>;
+
 }  // namespace sony9pin
 
 namespace Sony9PinRemote = sony9pin;
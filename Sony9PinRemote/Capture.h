@@ -0,0 +1,227 @@
+#pragma once
+#ifndef SONY9PINREMOTE_CAPTURE_H
+#define SONY9PINREMOTE_CAPTURE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdio.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Types.h"
+#include "Decoder.h"
+
+namespace sony9pin {
+
+// Binary capture of the bytes on the wire in both directions.
+//
+// File format (little endian, all integers in records are unsigned LEB128 varints):
+//   header : "S9PC" (4 bytes), version (1 byte, = 1), reserved (3 bytes, = 0)
+//   record : varint((delta_us << 1) | direction), varint(size), bytes[size]
+// delta_us is the time from the previous record (from 0 for the first one) in microseconds
+// of the Controller clock, so a record of a short packet usually takes only 2 + size bytes.
+
+enum class CaptureDirection : uint8_t {
+    TX = 0,  // controller -> device
+    RX = 1,  // device -> controller
+};
+
+// called by Controller for every block written to / read from the stream
+using CaptureHook = void (*)(const CaptureDirection dir, const uint8_t* data, const size_t size, const uint32_t timestamp_us, void* context);
+
+namespace capture {
+    static constexpr uint8_t MAGIC[4] {'S', '9', 'P', 'C'};
+    static constexpr uint8_t VERSION {1};
+    static constexpr size_t HEADER_SIZE {8};
+    static constexpr size_t MAX_VARINT_SIZE {5};  // uint32_t
+
+    inline size_t put_varint(uint8_t* out, uint32_t v) {
+        size_t n = 0;
+        while (v >= 0x80) {
+            out[n++] = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        out[n++] = (uint8_t)v;
+        return n;
+    }
+
+    // returns the number of bytes read, or 0 if truncated / too long
+    inline size_t get_varint(const uint8_t* in, const size_t size, uint32_t& v) {
+        v = 0;
+        for (size_t n = 0; n < size && n < MAX_VARINT_SIZE; ++n) {
+            v |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+            if (!(in[n] & 0x80)) return n + 1;
+        }
+        return 0;
+    }
+}  // namespace capture
+
+// =============== Writer ===============
+
+// Encodes the blocks into a buffer and passes it to the sink when full (or on `flush()`),
+// so the hook itself never blocks on I/O unless the buffer overflows.
+//
+//     CaptureWriter<> writer(capture_file_sink, fopen("deck.s9pc", "wb"));
+//     deck.set_capture_hook(CaptureWriter<>::hook, &writer);
+template <size_t BUFFER_SIZE = 512>
+class CaptureWriter {
+    static_assert(BUFFER_SIZE >= capture::HEADER_SIZE + 2 * capture::MAX_VARINT_SIZE, "CaptureWriter buffer is too small");
+
+public:
+    // returns the number of bytes written
+    using Sink = size_t (*)(const uint8_t* data, const size_t size, void* context);
+
+private:
+    Sink sink {nullptr};
+    void* sink_context {nullptr};
+    uint8_t buffer[BUFFER_SIZE];
+    size_t used {0};
+    uint32_t last_us {0};
+    bool b_first {true};
+    size_t n_records {0};
+    size_t n_lost {0};  // bytes which the sink could not write
+
+public:
+    CaptureWriter(Sink s, void* context) : sink(s), sink_context(context) {
+        memcpy(buffer, capture::MAGIC, sizeof(capture::MAGIC));
+        buffer[4] = capture::VERSION;
+        buffer[5] = buffer[6] = buffer[7] = 0;
+        used = capture::HEADER_SIZE;
+    }
+
+    ~CaptureWriter() { flush(); }
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    void write(const CaptureDirection dir, const uint8_t* data, const size_t size, const uint32_t timestamp_us) {
+        const uint32_t delta = b_first ? timestamp_us : (uint32_t)(timestamp_us - last_us);
+        b_first = false;
+        last_us = timestamp_us;
+        // the delta is saturated at 2^31 us (~35 min); longer gaps are rare and only shift the timeline
+        const uint32_t tag = ((delta < 0x80000000) ? (delta << 1) : 0xFFFFFFFE) | (uint32_t)dir;
+
+        if (BUFFER_SIZE - used < 2 * capture::MAX_VARINT_SIZE + size) flush();
+        used += capture::put_varint(buffer + used, tag);
+        used += capture::put_varint(buffer + used, (uint32_t)size);
+        if (BUFFER_SIZE - used >= size) {
+            memcpy(buffer + used, data, size);
+            used += size;
+        } else {
+            // larger than the buffer: write through
+            flush();
+            emit(data, size);
+        }
+        ++n_records;
+    }
+
+    void flush() {
+        if (used == 0) return;
+        emit(buffer, used);
+        used = 0;
+    }
+
+    size_t records() const { return n_records; }
+    size_t lost_bytes() const { return n_lost; }
+
+    // for Controller::set_capture_hook() with `this` as the context
+    static void hook(const CaptureDirection dir, const uint8_t* data, const size_t size, const uint32_t timestamp_us, void* context) {
+        static_cast<CaptureWriter*>(context)->write(dir, data, size, timestamp_us);
+    }
+
+private:
+    void emit(const uint8_t* data, const size_t size) {
+        const size_t n = sink ? sink(data, size, sink_context) : 0;
+        if (n < size) n_lost += size - n;
+    }
+};
+
+#ifndef ARDUINO
+// sink for CaptureWriter with a FILE* as the context
+inline size_t capture_file_sink(const uint8_t* data, const size_t size, void* file) {
+    return file ? fwrite(data, 1, size, (FILE*)file) : 0;
+}
+#endif
+
+// =============== Reader ===============
+
+struct CaptureRecord {
+    CaptureDirection dir {CaptureDirection::TX};
+    uint64_t timestamp_us {0};  // accumulated from the first record
+    const uint8_t* data {nullptr};
+    size_t size {0};
+};
+
+// Zero-copy reader over a capture in memory (e.g. mmap'ed file).
+class CaptureReader {
+    const uint8_t* begin;
+    const uint8_t* end;
+    const uint8_t* p;
+    uint64_t now_us {0};
+    bool b_valid {false};
+    bool b_truncated {false};
+
+public:
+    CaptureReader(const uint8_t* data, const size_t size) : begin(data), end(data + size), p(data) {
+        b_valid = (size >= capture::HEADER_SIZE) && (memcmp(data, capture::MAGIC, sizeof(capture::MAGIC)) == 0)
+               && (data[4] == capture::VERSION);
+        if (b_valid) p += capture::HEADER_SIZE;
+    }
+
+    bool valid() const { return b_valid; }
+    // true if the capture ends in the middle of a record (e.g. not flushed)
+    bool truncated() const { return b_truncated; }
+    size_t offset() const { return (size_t)(p - begin); }
+    size_t size() const { return (size_t)(end - begin); }
+
+    bool next(CaptureRecord& r) {
+        if (!b_valid || p == end) return false;
+        uint32_t tag = 0, size = 0;
+        const size_t n_tag = capture::get_varint(p, (size_t)(end - p), tag);
+        const size_t n_size = n_tag ? capture::get_varint(p + n_tag, (size_t)(end - p) - n_tag, size) : 0;
+        if (!n_tag || !n_size || (size_t)(end - p) - n_tag - n_size < size) {
+            b_truncated = true;
+            p = end;
+            return false;
+        }
+        now_us += tag >> 1;
+        r.dir = (CaptureDirection)(tag & 1);
+        r.timestamp_us = now_us;
+        r.data = p + n_tag + n_size;
+        r.size = size;
+        p = r.data + size;
+        return true;
+    }
+};
+
+// =============== Replay ===============
+
+// called for every packet completed while replaying
+// (`decoder` holds the packet; TX packets are the commands, RX packets are the replies)
+using ReplayHandler = void (*)(const CaptureDirection dir, const Decoder& decoder, const uint64_t timestamp_us, void* context);
+
+// Feed every record of the capture into the decoder of its direction.
+// `tx` is switched to `accept_commands()` mode. Returns the number of packets completed.
+inline size_t replay(CaptureReader& reader, Decoder& tx, Decoder& rx, ReplayHandler handler, void* context) {
+    tx.accept_commands(true);
+    size_t packets = 0;
+    CaptureRecord r;
+    while (reader.next(r)) {
+        Decoder& d = (r.dir == CaptureDirection::TX) ? tx : rx;
+        size_t consumed = 0;
+        while (consumed < r.size || d.pending()) {
+            const FeedResult result = d.feed(r.data + consumed, r.size - consumed, handler != nullptr);
+            consumed += result.consumed;
+            packets += result.packets;
+            if (handler && result.packets) handler(r.dir, d, r.timestamp_us, context);
+        }
+    }
+    return packets;
+}
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_CAPTURE_H
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef SONY9PINREMOTE_CLOCK_H
+#define SONY9PINREMOTE_CLOCK_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+#include <stdint.h>
+
+namespace sony9pin {
+
+// Clocks used as the timing policy of `BasicController`.
+// A clock has only `static uint32_t micros()`, a monotonic counter in microseconds
+// which wraps around every ~71.6 minutes. Every user of it compares the time by the
+// difference of two readings, so the wrap-around does not matter.
+
+#ifdef ARDUINO
+
+struct ArduinoClock {
+    static uint32_t micros() { return ::micros(); }
+};
+
+#else
+
+// std::chrono::steady_clock is never adjusted and keeps counting while the process is blocked
+struct SteadyClock {
+    static uint32_t micros() {
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#endif
+
+// Clock which moves only when it is told to, for tests.
+// `set_step()` advances the time on every reading, so that loops waiting for a timeout terminate.
+struct FakeClock {
+    static uint32_t micros() {
+        const uint32_t t = now();
+        now() += step();
+        return t;
+    }
+    static void set(const uint32_t us) { now() = us; }
+    static void advance(const uint32_t us) { now() += us; }
+    static void set_step(const uint32_t us) { step() = us; }
+
+private:
+    static uint32_t& now() {
+        static uint32_t t {0};
+        return t;
+    }
+    static uint32_t& step() {
+        static uint32_t s {0};
+        return s;
+    }
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_CLOCK_H
@@ -0,0 +1,156 @@
+#pragma once
+#ifndef SONY9PINREMOTE_COMMAND_QUEUE_H
+#define SONY9PINREMOTE_COMMAND_QUEUE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Types.h"
+#include "Commands.h"
+
+namespace sony9pin {
+
+// 0 is never used as an id, and means that the command was not accepted
+using CommandId = uint16_t;
+
+enum class CommandStatus : uint8_t {
+    QUEUED,   // waiting for the previous command to complete
+    SENT,     // written to the stream, waiting for the reply
+    ACK,      // completed with ACK
+    NAK,      // completed with NAK (see `errors`)
+    REPLY,    // completed with the other reply (see `reply`)
+    TIMEOUT,  // no reply until the deadline
+    CANCELLED,  // removed from the queue before it was written
+};
+
+struct CommandRecord {
+    CommandId id {0};
+    CommandStatus status {CommandStatus::QUEUED};
+    ReplyType expected {ReplyType::ACK};
+    uint8_t packet[MAX_PACKET_SIZE];
+    uint8_t size {0};
+    uint32_t queued_us {0};
+    uint32_t sent_us {0};
+    uint32_t deadline_us {0};
+    uint32_t replied_us {0};         // valid if status is ACK / NAK / REPLY
+    Errors errors;                   // valid if status == NAK
+    Cmd1 reply_cmd1 {Cmd1::NA};      // valid if status is ACK / NAK / REPLY
+    uint8_t reply_cmd2 {0xFF};       // valid if status is ACK / NAK / REPLY
+    uint8_t reply[MAX_PACKET_SIZE];  // data bytes of the reply (without cmd1, cmd2 and checksum)
+    uint8_t reply_size {0};
+
+    Cmd1 cmd1() const { return (Cmd1)(packet[0] & (uint8_t)HeaderMask::CMD1); }
+    uint8_t cmd2() const { return packet[1]; }
+    bool pending() const { return (status == CommandStatus::QUEUED) || (status == CommandStatus::SENT); }
+    bool completed() const { return !pending(); }
+};
+
+// queueing delay (from push to write) of the commands sent so far
+struct QueueDelayStats {
+    uint32_t count {0};
+    uint32_t min_us {0xFFFFFFFF};
+    uint32_t max_us {0};
+    uint32_t last_us {0};
+    uint64_t total_us {0};
+
+    void add(const uint32_t us) {
+        ++count;
+        if (us < min_us) min_us = us;
+        if (us > max_us) max_us = us;
+        last_us = us;
+        total_us += us;
+    }
+    uint32_t average_us() const { return count ? (uint32_t)(total_us / count) : 0; }
+};
+
+// Fixed-size FIFO of commands which also keeps the completed records
+// until their slots are reused by newer commands.
+template <size_t N>
+class CommandQueue {
+    static_assert(N > 0, "CommandQueue size must be greater than 0");
+
+    CommandRecord records[N];
+    size_t head {0};   // index of the oldest pending command
+    size_t count {0};  // number of pending commands
+    CommandId next_id {1};
+
+public:
+    // returns nullptr if the queue is full
+    CommandRecord* push(const uint8_t* data, const uint8_t size, const ReplyType expected, const uint32_t now_us) {
+        if (full() || size == 0 || size > MAX_PACKET_SIZE) return nullptr;
+        CommandRecord& r = records[(head + count) % N];
+        r = CommandRecord();
+        r.id = next_id++;
+        if (next_id == 0) next_id = 1;
+        r.expected = expected;
+        memcpy(r.packet, data, size);
+        r.size = size;
+        r.queued_us = now_us;
+        ++count;
+        return &r;
+    }
+
+    // Push a command at `pos` of the pending commands (0 = front) instead of the back,
+    // e.g. for a command written ahead of the queued ones. Returns nullptr if the queue is full.
+    CommandRecord* insert(const size_t pos, const uint8_t* data, const uint8_t size, const ReplyType expected, const uint32_t now_us) {
+        if (pos > count) return nullptr;
+        if (!push(data, size, expected, now_us)) return nullptr;
+        for (size_t i = count - 1; i > pos; --i) {
+            CommandRecord tmp = records[(head + i) % N];
+            records[(head + i) % N] = records[(head + i - 1) % N];
+            records[(head + i - 1) % N] = tmp;
+        }
+        return &records[(head + pos) % N];
+    }
+
+    // Remove the pending command at `pos` (0 = front) and move the later ones forward.
+    // Its record is kept until overwritten, like the popped ones.
+    bool erase(const size_t pos) {
+        if (pos >= count) return false;
+        for (size_t i = pos; i + 1 < count; ++i) {
+            CommandRecord tmp = records[(head + i) % N];
+            records[(head + i) % N] = records[(head + i + 1) % N];
+            records[(head + i + 1) % N] = tmp;
+        }
+        --count;
+        return true;
+    }
+
+    // the oldest pending command
+    CommandRecord* front() { return empty() ? nullptr : &records[head]; }
+    const CommandRecord* front() const { return empty() ? nullptr : &records[head]; }
+    // i-th pending command from the oldest one
+    CommandRecord* at(const size_t i) { return (i < count) ? &records[(head + i) % N] : nullptr; }
+    const CommandRecord* at(const size_t i) const { return (i < count) ? &records[(head + i) % N] : nullptr; }
+
+    // remove the oldest pending command (its record is kept until overwritten)
+    void pop() {
+        if (empty()) return;
+        head = (head + 1) % N;
+        --count;
+    }
+
+    // returns nullptr if the record has been already overwritten
+    const CommandRecord* find(const CommandId id) const {
+        for (size_t i = 0; i < N; ++i)
+            if (records[i].id == id && id != 0) return &records[i];
+        return nullptr;
+    }
+
+    void clear() {
+        head = count = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    static constexpr size_t capacity() { return N; }
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_COMMAND_QUEUE_H
@@ -0,0 +1,342 @@
+#pragma once
+#ifndef SONY9PINREMOTE_COMMANDS_H
+#define SONY9PINREMOTE_COMMANDS_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+
+#include "Types.h"
+
+namespace sony9pin {
+
+// Metadata of every command and reply in one table keyed by (cmd1, cmd2).
+// The lookups are switches generated from the lists below, so they compile to jump tables (O(1)),
+// and adding a command is one line in the list.
+//
+//     const CommandInfo info = command_info(packet[0], packet[1]);
+//     if (info.known() && info.accepts(packet[0] & 0x0F)) ...
+//
+// `command_name()` / `reply_name()` are separate from the other metadata so that
+// the strings are not linked into MCU builds which never print them.
+
+// type of the reply which the device should return for a command
+enum class ReplyType : uint8_t {
+    ACK,          // 10.01 ACK
+    DEVICE_TYPE,  // 12.11 DEVICE TYPE
+    SENSE,        // 7X.XX sense return
+};
+
+// data size which depends on the arguments (e.g. 1 or 2 bytes of speed data)
+static constexpr uint8_t VARIABLE_SIZE {0xFF};
+// sense return which depends on the data of the request (e.g. CURRENT TIME SENSE)
+static constexpr uint8_t VARIABLE_REPLY {0xFF};
+// data size of the sense returns with timecode only / timecode and userbits (e.g. 74.04 / 78.04),
+// which share the same cmd2 and so are VARIABLE_SIZE in the reply table
+static constexpr uint8_t TIMECODE_SIZE {4};
+static constexpr uint8_t TIMECODE_USERBITS_SIZE {8};
+
+namespace CommandFlag {
+    enum : uint8_t {
+        TIMECODE = 0b00000001,         // data starts with a BCD timecode (FF SS MM HH)
+        BMD = 0b00000010,              // BlackMagic extension
+        NOT_IMPLEMENTED = 0b00000100,  // no encoder in this library yet
+    };
+}
+
+// List of all commands as (Cmd1, Cmd2, name, data size, reply type, sense return, sense return data size, CommandFlag).
+// The sense return columns are used only for ReplyType::SENSE.
+// BlackMagic commands which share cmd2 with a standard one are in SONY9PIN_COMMAND_ALIASES.
+#define SONY9PIN_COMMANDS(X)                                                                                                                           \
+    /* ===== 0 - System Control ===== */                                                                                                               \
+    X(SYSTEM_CONTROL, SystemCtrl::LOCAL_DISABLE, LOCAL_DISABLE, 0, ACK, 0, 0, 0)                                                                       \
+    X(SYSTEM_CONTROL, SystemCtrl::DEVICE_TYPE, DEVICE_TYPE, 0, DEVICE_TYPE, 0, 0, 0)                                                                   \
+    X(SYSTEM_CONTROL, SystemCtrl::LOCAL_ENABLE, LOCAL_ENABLE, 0, ACK, 0, 0, 0)                                                                         \
+    X(SYSTEM_CONTROL, SystemCtrl::BMD_SEEK_TO_TIMELINE_POS, BMD_SEEK_TO_TIMELINE_POS, 2, ACK, 0, 0, CommandFlag::BMD)                                  \
+    /* ===== 2 - Transport Control ===== */                                                                                                            \
+    X(TRANSPORT_CONTROL, TransportCtrl::STOP, STOP, 0, ACK, 0, 0, 0)                                                                                   \
+    X(TRANSPORT_CONTROL, TransportCtrl::PLAY, PLAY, 0, ACK, 0, 0, 0)                                                                                   \
+    X(TRANSPORT_CONTROL, TransportCtrl::RECORD, RECORD, 0, ACK, 0, 0, 0)                                                                               \
+    X(TRANSPORT_CONTROL, TransportCtrl::STANDBY_OFF, STANDBY_OFF, 0, ACK, 0, 0, 0)                                                                     \
+    X(TRANSPORT_CONTROL, TransportCtrl::STANDBY_ON, STANDBY_ON, 0, ACK, 0, 0, 0)                                                                       \
+    X(TRANSPORT_CONTROL, TransportCtrl::EJECT, EJECT, 0, ACK, 0, 0, 0)                                                                                 \
+    X(TRANSPORT_CONTROL, TransportCtrl::FAST_FWD, FAST_FWD, 0, ACK, 0, 0, 0)                                                                           \
+    X(TRANSPORT_CONTROL, TransportCtrl::JOG_FWD, JOG_FWD, VARIABLE_SIZE, ACK, 0, 0, 0)                                                                 \
+    X(TRANSPORT_CONTROL, TransportCtrl::VAR_FWD, VAR_FWD, VARIABLE_SIZE, ACK, 0, 0, 0)                                                                 \
+    X(TRANSPORT_CONTROL, TransportCtrl::SHUTTLE_FWD, SHUTTLE_FWD, VARIABLE_SIZE, ACK, 0, 0, 0)                                                         \
+    X(TRANSPORT_CONTROL, TransportCtrl::FRAME_STEP_FWD, FRAME_STEP_FWD, 0, ACK, 0, 0, 0)                                                               \
+    X(TRANSPORT_CONTROL, TransportCtrl::REWIND, REWIND, 0, ACK, 0, 0, 0)                                                                               \
+    X(TRANSPORT_CONTROL, TransportCtrl::JOG_REV, JOG_REV, VARIABLE_SIZE, ACK, 0, 0, 0)                                                                 \
+    X(TRANSPORT_CONTROL, TransportCtrl::VAR_REV, VAR_REV, VARIABLE_SIZE, ACK, 0, 0, 0)                                                                 \
+    X(TRANSPORT_CONTROL, TransportCtrl::SHUTTLE_REV, SHUTTLE_REV, VARIABLE_SIZE, ACK, 0, 0, 0)                                                         \
+    X(TRANSPORT_CONTROL, TransportCtrl::FRAME_STEP_REV, FRAME_STEP_REV, 0, ACK, 0, 0, 0)                                                               \
+    X(TRANSPORT_CONTROL, TransportCtrl::PREROLL, PREROLL, 0, ACK, 0, 0, 0)                                                                             \
+    X(TRANSPORT_CONTROL, TransportCtrl::CUE_UP_WITH_DATA, CUE_UP_WITH_DATA, 4, ACK, 0, 0, CommandFlag::TIMECODE)                                       \
+    X(TRANSPORT_CONTROL, TransportCtrl::SYNC_PLAY, SYNC_PLAY, 0, ACK, 0, 0, 0)                                                                         \
+    X(TRANSPORT_CONTROL, TransportCtrl::PROG_SPEED_PLAY_PLUS, PROG_SPEED_PLAY_PLUS, 1, ACK, 0, 0, 0)                                                   \
+    X(TRANSPORT_CONTROL, TransportCtrl::PROG_SPEED_PLAY_MINUS, PROG_SPEED_PLAY_MINUS, 1, ACK, 0, 0, 0)                                                 \
+    X(TRANSPORT_CONTROL, TransportCtrl::PREVIEW, PREVIEW, 0, ACK, 0, 0, 0)                                                                             \
+    X(TRANSPORT_CONTROL, TransportCtrl::REVIEW, REVIEW, 0, ACK, 0, 0, 0)                                                                               \
+    X(TRANSPORT_CONTROL, TransportCtrl::AUTO_EDIT, AUTO_EDIT, 0, ACK, 0, 0, 0)                                                                         \
+    X(TRANSPORT_CONTROL, TransportCtrl::OUTPOINT_PREVIEW, OUTPOINT_PREVIEW, 0, ACK, 0, 0, 0)                                                           \
+    X(TRANSPORT_CONTROL, TransportCtrl::ANTI_CLOG_TIMER_DISABLE, ANTI_CLOG_TIMER_DISABLE, 0, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                  \
+    X(TRANSPORT_CONTROL, TransportCtrl::ANTI_CLOG_TIMER_ENABLE, ANTI_CLOG_TIMER_ENABLE, 0, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                    \
+    X(TRANSPORT_CONTROL, TransportCtrl::DMC_SET_FWD, DMC_SET_FWD, 2, ACK, 0, 0, 0)                                                                     \
+    X(TRANSPORT_CONTROL, TransportCtrl::DMC_SET_REV, DMC_SET_REV, 2, ACK, 0, 0, 0)                                                                     \
+    X(TRANSPORT_CONTROL, TransportCtrl::FULL_EE_OFF, FULL_EE_OFF, 0, ACK, 0, 0, 0)                                                                     \
+    X(TRANSPORT_CONTROL, TransportCtrl::FULL_EE_ON, FULL_EE_ON, 0, ACK, 0, 0, 0)                                                                       \
+    X(TRANSPORT_CONTROL, TransportCtrl::SELECT_EE_ON, SELECT_EE_ON, 0, ACK, 0, 0, 0)                                                                   \
+    X(TRANSPORT_CONTROL, TransportCtrl::EDIT_OFF, EDIT_OFF, 0, ACK, 0, 0, 0)                                                                           \
+    X(TRANSPORT_CONTROL, TransportCtrl::EDIT_ON, EDIT_ON, 0, ACK, 0, 0, 0)                                                                             \
+    X(TRANSPORT_CONTROL, TransportCtrl::FREEZE_OFF, FREEZE_OFF, 0, ACK, 0, 0, 0)                                                                       \
+    X(TRANSPORT_CONTROL, TransportCtrl::FREEZE_ON, FREEZE_ON, 0, ACK, 0, 0, 0)                                                                         \
+    X(TRANSPORT_CONTROL, TransportCtrl::CLEAR_PLAYLIST, CLEAR_PLAYLIST, 0, ACK, 0, 0, CommandFlag::BMD)                                                \
+    /* ===== 4 - Preset/Select Control ===== */                                                                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::TIMER_1_PRESET, TIMER_1_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE)                                    \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::TIME_CODE_PRESET, TIME_CODE_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE)                                \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::USER_BIT_PRESET, USER_BIT_PRESET, 4, ACK, 0, 0, 0)                                                      \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::TIMER_1_RESET, TIMER_1_RESET, 0, ACK, 0, 0, 0)                                                          \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_ENTRY, IN_ENTRY, 0, ACK, 0, 0, 0)                                                                    \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_ENTRY, OUT_ENTRY, 0, ACK, 0, 0, 0)                                                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_ENTRY, AUDIO_IN_ENTRY, 0, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                             \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_ENTRY, AUDIO_OUT_ENTRY, 0, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                           \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_DATA_PRESET, IN_DATA_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE)                                    \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_DATA_PRESET, OUT_DATA_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE)                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_DATA_PRESET, AUDIO_IN_DATA_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE | CommandFlag::NOT_IMPLEMENTED)   \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_DATA_PRESET, AUDIO_OUT_DATA_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE | CommandFlag::NOT_IMPLEMENTED) \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_SHIFT_PLUS, IN_SHIFT_PLUS, 0, ACK, 0, 0, 0)                                                          \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_SHIFT_MINUS, IN_SHIFT_MINUS, 0, ACK, 0, 0, 0)                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_SHIFT_PLUS, OUT_SHIFT_PLUS, 0, ACK, 0, 0, 0)                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_SHIFT_MINUS, OUT_SHIFT_MINUS, 0, ACK, 0, 0, 0)                                                      \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_SHIFT_PLUS, AUDIO_IN_SHIFT_PLUS, 0, ACK, 0, 0, 0)                                              \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_SHIFT_MINUS, AUDIO_IN_SHIFT_MINUS, 0, ACK, 0, 0, 0)                                            \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_SHIFT_PLUS, AUDIO_OUT_SHIFT_PLUS, 0, ACK, 0, 0, 0)                                            \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_SHIFT_MINUS, AUDIO_OUT_SHIFT_MINUS, 0, ACK, 0, 0, 0)                                          \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_FLAG_RESET, IN_FLAG_RESET, 0, ACK, 0, 0, 0)                                                          \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_FLAG_RESET, OUT_FLAG_RESET, 0, ACK, 0, 0, 0)                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_FLAG_RESET, AUDIO_IN_FLAG_RESET, 0, ACK, 0, 0, 0)                                              \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_FLAG_RESET, AUDIO_OUT_FLAG_RESET, 0, ACK, 0, 0, 0)                                            \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_RECALL, IN_RECALL, 0, ACK, 0, 0, 0)                                                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_RECALL, OUT_RECALL, 0, ACK, 0, 0, 0)                                                                \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_RECALL, AUDIO_IN_RECALL, 0, ACK, 0, 0, 0)                                                      \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_RECALL, AUDIO_OUT_RECALL, 0, ACK, 0, 0, 0)                                                    \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::LOST_LOCK_RESET, LOST_LOCK_RESET, 0, ACK, 0, 0, 0)                                                      \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::EDIT_PRESET, EDIT_PRESET, VARIABLE_SIZE, ACK, 0, 0, 0)                                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::PREROLL_PRESET, PREROLL_PRESET, 4, ACK, 0, 0, CommandFlag::TIMECODE)                                    \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::TAPE_AUDIO_SELECT, TAPE_AUDIO_SELECT, 1, ACK, 0, 0, 0)                                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::SERVO_REF_SELECT, SERVO_REF_SELECT, 1, ACK, 0, 0, 0)                                                    \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::HEAD_SELECT, HEAD_SELECT, 1, ACK, 0, 0, 0)                                                              \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::COLOR_FRAME_SELECT, COLOR_FRAME_SELECT, 1, ACK, 0, 0, 0)                                                \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::TIMER_MODE_SELECT, TIMER_MODE_SELECT, 1, ACK, 0, 0, 0)                                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::INPUT_CHECK, INPUT_CHECK, 1, ACK, 0, 0, 0)                                                              \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::EDIT_FIELD_SELECT, EDIT_FIELD_SELECT, 1, ACK, 0, 0, 0)                                                  \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::FREEZE_MODE_SELECT, FREEZE_MODE_SELECT, 1, ACK, 0, 0, 0)                                                \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::RECORD_INHIBIT, RECORD_INHIBIT, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                 \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUTO_MODE_OFF, AUTO_MODE_OFF, 0, ACK, 0, 0, 0)                                                          \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUTO_MODE_ON, AUTO_MODE_ON, 0, ACK, 0, 0, 0)                                                            \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::SPOT_ERASE_OFF, SPOT_ERASE_OFF, 0, ACK, 0, 0, 0)                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::SPOT_ERASE_ON, SPOT_ERASE_ON, 0, ACK, 0, 0, 0)                                                          \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_SPLIT_OFF, AUDIO_SPLIT_OFF, 0, ACK, 0, 0, 0)                                                      \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_SPLIT_ON, AUDIO_SPLIT_ON, 0, ACK, 0, 0, 0)                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUTPUT_H_PHASE, OUTPUT_H_PHASE, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                 \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::OUTPUT_VIDEO_PHASE, OUTPUT_VIDEO_PHASE, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)         \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_INPUT_LEVEL, AUDIO_INPUT_LEVEL, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)           \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUTPUT_LEVEL, AUDIO_OUTPUT_LEVEL, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)         \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_ADV_LEVEL, AUDIO_ADV_LEVEL, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)               \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUTPUT_PHASE, AUDIO_OUTPUT_PHASE, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)         \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_ADV_OUTPUT_PHASE, AUDIO_ADV_OUTPUT_PHASE, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED) \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::CROSS_FADE_TIME_PRESET, CROSS_FADE_TIME_PRESET, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED) \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::LOCAL_KEY_MAP, LOCAL_KEY_MAP, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::NOT_IMPLEMENTED)                   \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::STILL_OFF_TIME, STILL_OFF_TIME, 2, ACK, 0, 0, 0)                                                        \
+    X(PRESET_SELECT_CONTROL, PresetSelectCtrl::STBY_OFF_TIME, STBY_OFF_TIME, 2, ACK, 0, 0, 0)                                                          \
+    /* ===== 6 - Sense Request ===== */                                                                                                                \
+    X(SENSE_REQUEST, SenseRequest::TC_GEN_SENSE, TC_GEN_SENSE, 1, SENSE, VARIABLE_REPLY, VARIABLE_SIZE, 0)                                            \
+    X(SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CURRENT_TIME_SENSE, 1, SENSE, VARIABLE_REPLY, VARIABLE_SIZE, 0)                                \
+    X(SENSE_REQUEST, SenseRequest::IN_DATA_SENSE, IN_DATA_SENSE, 0, SENSE, SenseReturn::IN_DATA, 4, 0)                                                 \
+    X(SENSE_REQUEST, SenseRequest::OUT_DATA_SENSE, OUT_DATA_SENSE, 0, SENSE, SenseReturn::OUT_DATA, 4, 0)                                              \
+    X(SENSE_REQUEST, SenseRequest::AUDIO_IN_DATA_SENSE, AUDIO_IN_DATA_SENSE, 0, SENSE, SenseReturn::AUDIO_IN_DATA, 4, 0)                               \
+    X(SENSE_REQUEST, SenseRequest::AUDIO_OUT_DATA_SENSE, AUDIO_OUT_DATA_SENSE, 0, SENSE, SenseReturn::AUDIO_OUT_DATA, 4, 0)                            \
+    X(SENSE_REQUEST, SenseRequest::STATUS_SENSE, STATUS_SENSE, 1, SENSE, SenseReturn::STATUS_DATA, VARIABLE_SIZE, 0)                                  \
+    X(SENSE_REQUEST, SenseRequest::EXTENDED_VTR_STATUS, EXTENDED_VTR_STATUS, 1, SENSE, SenseReturn::EXTENDED_STATUS_DATA, VARIABLE_SIZE, 0)           \
+    X(SENSE_REQUEST, SenseRequest::SIGNAL_CONTROL_SENSE, SIGNAL_CONTROL_SENSE, 2, SENSE, SenseReturn::SIGNAL_CONTROL_DATA, VARIABLE_SIZE, 0)          \
+    X(SENSE_REQUEST, SenseRequest::LOCAL_KEYMAP_SENSE, LOCAL_KEYMAP_SENSE, VARIABLE_SIZE, SENSE, SenseReturn::LOCAL_KEYMAP, VARIABLE_SIZE, CommandFlag::NOT_IMPLEMENTED) \
+    X(SENSE_REQUEST, SenseRequest::HEAD_METER_SENSE, HEAD_METER_SENSE, 1, SENSE, SenseReturn::HEAD_METER_DATA, VARIABLE_SIZE, 0)                      \
+    X(SENSE_REQUEST, SenseRequest::REMAINING_TIME_SENSE, REMAINING_TIME_SENSE, 0, SENSE, SenseReturn::REMAINING_TIME, VARIABLE_SIZE, 0)               \
+    X(SENSE_REQUEST, SenseRequest::CMD_SPEED_SENSE, CMD_SPEED_SENSE, 0, SENSE, SenseReturn::CMD_SPEED_DATA, VARIABLE_SIZE, 0)                         \
+    X(SENSE_REQUEST, SenseRequest::EDIT_PRESET_SENSE, EDIT_PRESET_SENSE, 1, SENSE, SenseReturn::EDIT_PRESET_STATUS, VARIABLE_SIZE, 0)                 \
+    X(SENSE_REQUEST, SenseRequest::PREROLL_TIME_SENSE, PREROLL_TIME_SENSE, 0, SENSE, SenseReturn::PREROLL_TIME, 4, 0)                                  \
+    X(SENSE_REQUEST, SenseRequest::TIMER_MODE_SENSE, TIMER_MODE_SENSE, 0, SENSE, SenseReturn::TIMER_MODE_STATUS, 1, 0)                                 \
+    X(SENSE_REQUEST, SenseRequest::RECORD_INHIBIT_SENSE, RECORD_INHIBIT_SENSE, 0, SENSE, SenseReturn::RECORD_INHIBIT_STATUS, VARIABLE_SIZE, 0)        \
+    X(SENSE_REQUEST, SenseRequest::DA_INPUT_EMPHASIS_SENSE, DA_INPUT_EMPHASIS_SENSE, 0, SENSE, SenseReturn::DA_INPUT_EMPHASIS_DATA, VARIABLE_SIZE, 0)  \
+    X(SENSE_REQUEST, SenseRequest::DA_PLAYBACK_EMPHASIS_SENSE, DA_PLAYBACK_EMPHASIS_SENSE, 0, SENSE, SenseReturn::DA_PLAYBACK_EMPHASIS_DATA, VARIABLE_SIZE, 0) \
+    X(SENSE_REQUEST, SenseRequest::DA_SAMPLING_FREQUENCY_SENSE, DA_SAMPLING_FREQUENCY_SENSE, 0, SENSE, SenseReturn::DA_SAMPLING_FREQUENCY_DATA, VARIABLE_SIZE, 0) \
+    X(SENSE_REQUEST, SenseRequest::CROSS_FADE_TIME_SENSE, CROSS_FADE_TIME_SENSE, 1, SENSE, SenseReturn::CROSS_FADE_TIME_DATA, VARIABLE_SIZE, 0)       \
+    /* ===== 8 - BlackMagic Extensions ===== */                                                                                                        \
+    X(BMD_EXTENSION, BmdExtensions::SEEK_RELATIVE_CLIP, BMD_SEEK_RELATIVE_CLIP, 1, ACK, 0, 0, CommandFlag::BMD)                                        \
+    /* ===== A - BlackMagic Advanced Media Protocol ===== */                                                                                           \
+    X(BMD_ADVANCED_MEDIA_PRTCL, BmdAdvancedMediaProtocol::AUTO_SKIP, AUTO_SKIP, 1, ACK, 0, 0, CommandFlag::BMD)                                        \
+    X(BMD_ADVANCED_MEDIA_PRTCL, BmdAdvancedMediaProtocol::LIST_NEXT_ID, LIST_NEXT_ID, VARIABLE_SIZE, ACK, 0, 0, CommandFlag::BMD | CommandFlag::NOT_IMPLEMENTED)
+
+// BlackMagic commands which share cmd2 with a standard command, keyed by the whole header byte
+// (same columns as SONY9PIN_COMMANDS, the Cmd1 column is the header with the data size)
+#define SONY9PIN_COMMAND_ALIASES(X)                                                                                         \
+    X(0x4F, PresetSelectCtrl::APPEND_PRESET, APPEND_PRESET, 15, ACK, 0, 0, CommandFlag::BMD | CommandFlag::NOT_IMPLEMENTED) \
+    X(0x41, PresetSelectCtrl::SET_PLAYBACK_LOOP, SET_PLAYBACK_LOOP, 1, ACK, 0, 0, CommandFlag::BMD)                          \
+    X(0x41, PresetSelectCtrl::SET_STOP_MODE, SET_STOP_MODE, 1, ACK, 0, 0, CommandFlag::BMD)
+
+// List of all replies as (Cmd1, Cmd2, name, data size, CommandFlag).
+// The aliases of SenseReturn (e.g. LTC_TC for LTC_TC_UB with 4 bytes) are the same entries with VARIABLE_SIZE.
+#define SONY9PIN_REPLIES(X)                                                                                         \
+    /* ===== 1 - System Control Return ===== */                                                                    \
+    X(SYSTEM_CONTROL_RETURN, SystemControlReturn::ACK, ACK, 0, 0)                                                   \
+    X(SYSTEM_CONTROL_RETURN, SystemControlReturn::NAK, NAK, 1, 0)                                                   \
+    X(SYSTEM_CONTROL_RETURN, SystemControlReturn::DEVICE_TYPE, DEVICE_TYPE, 2, 0)                                   \
+    /* ===== 7 - Sense Return ===== */                                                                             \
+    X(SENSE_RETURN, SenseReturn::TIMER_1, TIMER_1, VARIABLE_SIZE, CommandFlag::TIMECODE)                            \
+    X(SENSE_RETURN, SenseReturn::TIMER_2, TIMER_2, VARIABLE_SIZE, CommandFlag::TIMECODE)                            \
+    X(SENSE_RETURN, SenseReturn::LTC_TC_UB, LTC_TC_UB, VARIABLE_SIZE, CommandFlag::TIMECODE)                        \
+    X(SENSE_RETURN, SenseReturn::LTC_UB, LTC_UB, 4, 0)                                                              \
+    X(SENSE_RETURN, SenseReturn::VITC_TC_UB, VITC_TC_UB, VARIABLE_SIZE, CommandFlag::TIMECODE)                      \
+    X(SENSE_RETURN, SenseReturn::VITC_UB, VITC_UB, 4, 0)                                                            \
+    X(SENSE_RETURN, SenseReturn::GEN_TC_UB, GEN_TC_UB, VARIABLE_SIZE, CommandFlag::TIMECODE)                        \
+    X(SENSE_RETURN, SenseReturn::GEN_UB, GEN_UB, 4, 0)                                                              \
+    X(SENSE_RETURN, SenseReturn::IN_DATA, IN_DATA, 4, CommandFlag::TIMECODE)                                        \
+    X(SENSE_RETURN, SenseReturn::OUT_DATA, OUT_DATA, 4, CommandFlag::TIMECODE)                                      \
+    X(SENSE_RETURN, SenseReturn::AUDIO_IN_DATA, AUDIO_IN_DATA, 4, CommandFlag::TIMECODE)                            \
+    X(SENSE_RETURN, SenseReturn::AUDIO_OUT_DATA, AUDIO_OUT_DATA, 4, CommandFlag::TIMECODE)                          \
+    X(SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_TC_UB, LTC_INTERPOLATED_TC_UB, VARIABLE_SIZE, CommandFlag::TIMECODE) \
+    X(SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_UB, LTC_INTERPOLATED_UB, 4, 0)                                    \
+    X(SENSE_RETURN, SenseReturn::HOLD_VITC_TC_UB, HOLD_VITC_TC_UB, VARIABLE_SIZE, CommandFlag::TIMECODE)            \
+    X(SENSE_RETURN, SenseReturn::HOLD_VITC_UB, HOLD_VITC_UB, 4, 0)                                                  \
+    X(SENSE_RETURN, SenseReturn::STATUS_DATA, STATUS_DATA, VARIABLE_SIZE, 0)                                        \
+    X(SENSE_RETURN, SenseReturn::EXTENDED_STATUS_DATA, EXTENDED_STATUS_DATA, VARIABLE_SIZE, 0)                      \
+    X(SENSE_RETURN, SenseReturn::SIGNAL_CONTROL_DATA, SIGNAL_CONTROL_DATA, VARIABLE_SIZE, 0)                        \
+    X(SENSE_RETURN, SenseReturn::LOCAL_KEYMAP, LOCAL_KEYMAP, VARIABLE_SIZE, 0)                                      \
+    X(SENSE_RETURN, SenseReturn::HEAD_METER_DATA, HEAD_METER_DATA, VARIABLE_SIZE, 0)                                \
+    X(SENSE_RETURN, SenseReturn::REMAINING_TIME, REMAINING_TIME, VARIABLE_SIZE, 0)                                  \
+    X(SENSE_RETURN, SenseReturn::CMD_SPEED_DATA, CMD_SPEED_DATA, VARIABLE_SIZE, 0)                                  \
+    X(SENSE_RETURN, SenseReturn::EDIT_PRESET_STATUS, EDIT_PRESET_STATUS, VARIABLE_SIZE, 0)                          \
+    X(SENSE_RETURN, SenseReturn::PREROLL_TIME, PREROLL_TIME, 4, CommandFlag::TIMECODE)                              \
+    X(SENSE_RETURN, SenseReturn::TIMER_MODE_STATUS, TIMER_MODE_STATUS, 1, 0)                                        \
+    X(SENSE_RETURN, SenseReturn::RECORD_INHIBIT_STATUS, RECORD_INHIBIT_STATUS, VARIABLE_SIZE, 0)                    \
+    X(SENSE_RETURN, SenseReturn::DA_INPUT_EMPHASIS_DATA, DA_INPUT_EMPHASIS_DATA, VARIABLE_SIZE, 0)                  \
+    X(SENSE_RETURN, SenseReturn::DA_PLAYBACK_EMPHASIS_DATA, DA_PLAYBACK_EMPHASIS_DATA, VARIABLE_SIZE, 0)            \
+    X(SENSE_RETURN, SenseReturn::DA_SAMPLING_FREQUENCY_DATA, DA_SAMPLING_FREQUENCY_DATA, VARIABLE_SIZE, 0)          \
+    X(SENSE_RETURN, SenseReturn::CROSS_FADE_TIME_DATA, CROSS_FADE_TIME_DATA, VARIABLE_SIZE, 0)
+
+// =============== Metadata ===============
+
+struct CommandInfo {
+    Cmd1 cmd1;              // Cmd1::NA if the command is unknown
+    uint8_t cmd2;
+    uint8_t size;           // data bytes, or VARIABLE_SIZE
+    ReplyType reply;
+    uint8_t reply_cmd2;     // cmd2 of the reply (SystemControlReturn / SenseReturn), or VARIABLE_REPLY
+    uint8_t reply_size;     // data bytes of the reply, or VARIABLE_SIZE
+    uint8_t flags;          // CommandFlag
+
+    constexpr CommandInfo()
+    : cmd1(Cmd1::NA), cmd2(0xFF), size(VARIABLE_SIZE), reply(ReplyType::ACK), reply_cmd2(VARIABLE_REPLY), reply_size(VARIABLE_SIZE), flags(0) {}
+    constexpr CommandInfo(const Cmd1 c1, const uint8_t c2, const uint8_t sz, const ReplyType r, const uint8_t r_cmd2, const uint8_t r_size, const uint8_t f)
+    : cmd1(c1)
+    , cmd2(c2)
+    , size(sz)
+    , reply(r)
+    , reply_cmd2((r == ReplyType::ACK) ? (uint8_t)SystemControlReturn::ACK : (r == ReplyType::DEVICE_TYPE) ? (uint8_t)SystemControlReturn::DEVICE_TYPE : r_cmd2)
+    , reply_size((r == ReplyType::ACK) ? 0 : (r == ReplyType::DEVICE_TYPE) ? 2 : r_size)
+    , flags(f) {}
+
+    constexpr bool known() const { return cmd1 != Cmd1::NA; }
+    constexpr bool accepts(const uint8_t data_size) const { return known() && (size == VARIABLE_SIZE || size == data_size); }
+    constexpr bool timecode() const { return flags & CommandFlag::TIMECODE; }
+    constexpr bool bmd() const { return flags & CommandFlag::BMD; }
+    constexpr bool implemented() const { return !(flags & CommandFlag::NOT_IMPLEMENTED); }
+};
+
+struct ReplyInfo {
+    Cmd1 cmd1;  // Cmd1::NA if the reply is unknown
+    uint8_t cmd2;
+    uint8_t size;  // data bytes, or VARIABLE_SIZE
+    uint8_t flags;
+
+    constexpr ReplyInfo() : cmd1(Cmd1::NA), cmd2(0xFF), size(VARIABLE_SIZE), flags(0) {}
+    constexpr ReplyInfo(const Cmd1 c1, const uint8_t c2, const uint8_t sz, const uint8_t f) : cmd1(c1), cmd2(c2), size(sz), flags(f) {}
+
+    constexpr bool known() const { return cmd1 != Cmd1::NA; }
+    constexpr bool accepts(const uint8_t data_size) const { return known() && (size == VARIABLE_SIZE || size == data_size); }
+    constexpr bool timecode() const { return flags & CommandFlag::TIMECODE; }
+};
+
+// key of the lookup switches: header (or Cmd1) and cmd2
+constexpr uint16_t command_key(const uint8_t header, const uint8_t cmd2) {
+    return (uint16_t)(((uint16_t)header << 8) | cmd2);
+}
+
+// `header` is the first byte of the packet (Cmd1 | data size)
+inline CommandInfo command_info(const uint8_t header, const uint8_t cmd2) {
+#define SONY9PIN_COMMAND_ALIAS_CASE(h, c2, name, sz, r, r_cmd2, r_size, f) \
+    case command_key(h, c2): return CommandInfo((Cmd1)(h & HeaderMask::CMD1), c2, sz, ReplyType::r, r_cmd2, r_size, f);
+#define SONY9PIN_COMMAND_CASE(c1, c2, name, sz, r, r_cmd2, r_size, f) \
+    case command_key((uint8_t)Cmd1::c1, c2): return CommandInfo(Cmd1::c1, c2, sz, ReplyType::r, r_cmd2, r_size, f);
+    switch (command_key(header, cmd2)) {
+        SONY9PIN_COMMAND_ALIASES(SONY9PIN_COMMAND_ALIAS_CASE)
+        default: break;
+    }
+    switch (command_key(header & HeaderMask::CMD1, cmd2)) {
+        SONY9PIN_COMMANDS(SONY9PIN_COMMAND_CASE)
+        default: return CommandInfo();
+    }
+#undef SONY9PIN_COMMAND_CASE
+#undef SONY9PIN_COMMAND_ALIAS_CASE
+}
+
+inline ReplyInfo reply_info(const uint8_t header, const uint8_t cmd2) {
+#define SONY9PIN_REPLY_CASE(c1, c2, name, sz, f) \
+    case command_key((uint8_t)Cmd1::c1, c2): return ReplyInfo(Cmd1::c1, c2, sz, f);
+    switch (command_key(header & HeaderMask::CMD1, cmd2)) {
+        SONY9PIN_REPLIES(SONY9PIN_REPLY_CASE)
+        default: return ReplyInfo();
+    }
+#undef SONY9PIN_REPLY_CASE
+}
+
+// =============== Names ===============
+
+// e.g. "STATUS_SENSE", or nullptr if unknown
+inline const char* command_name(const uint8_t header, const uint8_t cmd2) {
+#define SONY9PIN_COMMAND_ALIAS_NAME(h, c2, name, sz, r, r_cmd2, r_size, f) \
+    case command_key(h, c2): return #name;
+#define SONY9PIN_COMMAND_NAME(c1, c2, name, sz, r, r_cmd2, r_size, f) \
+    case command_key((uint8_t)Cmd1::c1, c2): return #name;
+    switch (command_key(header, cmd2)) {
+        SONY9PIN_COMMAND_ALIASES(SONY9PIN_COMMAND_ALIAS_NAME)
+        default: break;
+    }
+    switch (command_key(header & HeaderMask::CMD1, cmd2)) {
+        SONY9PIN_COMMANDS(SONY9PIN_COMMAND_NAME)
+        default: return nullptr;
+    }
+#undef SONY9PIN_COMMAND_NAME
+#undef SONY9PIN_COMMAND_ALIAS_NAME
+}
+
+// e.g. "STATUS_DATA", or nullptr if unknown.
+// The BlackMagic groups are used in both directions, so their replies are named by `command_name()`.
+inline const char* reply_name(const uint8_t header, const uint8_t cmd2) {
+#define SONY9PIN_REPLY_NAME(c1, c2, name, sz, f) \
+    case command_key((uint8_t)Cmd1::c1, c2): return #name;
+    switch (command_key(header & HeaderMask::CMD1, cmd2)) {
+        SONY9PIN_REPLIES(SONY9PIN_REPLY_NAME)
+        default: break;
+    }
+#undef SONY9PIN_REPLY_NAME
+    const uint8_t cmd1 = header & HeaderMask::CMD1;
+    if (cmd1 == (uint8_t)Cmd1::BMD_EXTENSION || cmd1 == (uint8_t)Cmd1::BMD_ADVANCED_MEDIA_PRTCL)
+        return command_name(header, cmd2);
+    return nullptr;
+}
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_COMMANDS_H
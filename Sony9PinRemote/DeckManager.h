@@ -0,0 +1,284 @@
+#pragma once
+#ifndef SONY9PINREMOTE_DECK_MANAGER_H
+#define SONY9PINREMOTE_DECK_MANAGER_H
+
+#ifndef __linux__
+#error DeckManager requires Linux (epoll)
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include "../Sony9PinRemote.h"
+
+#ifdef SONY9PINREMOTE_DEBUGLOG_ENABLE
+#include <DebugLogEnable.h>
+#else
+#include <DebugLogDisable.h>
+#endif
+
+namespace sony9pin {
+
+// Single-thread reactor which services many Controllers (up to N) from one epoll instance.
+// Readable ports are parsed as soon as the bytes arrive, and the reply timeouts and
+// frame slots of every deck are run from one timer wheel, so nothing is polled per deck.
+//
+//     DeckManager<64> manager;
+//     int i = manager.add(deck, port);  // port is the PosixSerial attached to the deck
+//     manager.set_reply_handler(on_reply, &context);
+//     manager.set_timeout_handler(on_timeout, &context);  // e.g. to send the next command anyway
+//     while (running) manager.poll(100);
+//
+// All the Controllers must be used only from the thread calling `poll()`.
+// Commands sent outside of the reply / timeout handlers must be followed by `schedule(i)`
+// so that their timeout and pacing are registered to the wheel.
+template <typename Clock, size_t N>
+class BasicDeckManager {
+    static_assert(N > 0 && N < 0x7FFF, "BasicDeckManager size must be in 1 - 32766");
+
+public:
+    using ControllerType = BasicController<Clock>;
+    // called for every reply packet parsed by `deck` (index returned by `add()`)
+    using ReplyHandler = void (*)(const size_t index, ControllerType& deck, void* context);
+    // called when the command in flight of `deck` has timed out without a reply
+    using TimeoutHandler = void (*)(const size_t index, ControllerType& deck, void* context);
+
+private:
+    // 1 ms ticks (same resolution as epoll_wait) and 256 ms per lap.
+    // Longer timers are fired early and rescheduled by the remaining time.
+    enum : uint32_t {
+        TICK_US = 1000,
+        SLOTS = 256,
+        NO_TIMER = 0xFFFFFFFF,
+    };
+    enum : int16_t { NIL = -1 };
+
+    struct Entry {
+        ControllerType* deck {nullptr};
+        int fd {-1};
+        int16_t slot {NIL};  // slot of the wheel, or NIL if not scheduled
+        int16_t prev {NIL};
+        int16_t next {NIL};
+    };
+
+    int epfd {-1};
+    Entry entries[N];
+    size_t used {0};
+
+    int16_t wheel[SLOTS];
+    size_t cursor {0};      // slot of `wheel_us`
+    uint32_t wheel_us {0};  // start time of the current slot
+    size_t scheduled {0};
+
+    ReplyHandler handler {nullptr};
+    void* handler_context {nullptr};
+    TimeoutHandler timeout_handler {nullptr};
+    void* timeout_handler_context {nullptr};
+
+public:
+    BasicDeckManager() {
+        epfd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epfd < 0) LOG_ERROR("epoll_create1 failed: errno", errno);
+        for (auto& s : wheel) s = NIL;
+        wheel_us = Clock::micros();
+    }
+
+    ~BasicDeckManager() {
+        if (epfd >= 0) ::close(epfd);
+    }
+
+    BasicDeckManager(const BasicDeckManager&) = delete;
+    BasicDeckManager& operator=(const BasicDeckManager&) = delete;
+
+    bool valid() const { return epfd >= 0; }
+
+    // Register the deck and the port attached to it. Returns the index of the deck or -1.
+    int add(ControllerType& deck, const PosixSerial& port) {
+        if (!valid() || !port.is_open()) return -1;
+        size_t i = 0;
+        while (i < N && entries[i].deck) ++i;
+        if (i == N) {
+            LOG_WARN("DeckManager is full");
+            return -1;
+        }
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+        if (::epoll_ctl(epfd, EPOLL_CTL_ADD, port.handle(), &ev) != 0) {
+            LOG_ERROR("epoll_ctl failed: errno", errno);
+            return -1;
+        }
+        entries[i] = Entry();
+        entries[i].deck = &deck;
+        entries[i].fd = port.handle();
+        ++used;
+        schedule(i);
+        return (int)i;
+    }
+
+    void remove(const size_t i) {
+        if (i >= N || !entries[i].deck) return;
+        unlink(i);
+        ::epoll_ctl(epfd, EPOLL_CTL_DEL, entries[i].fd, nullptr);
+        entries[i] = Entry();
+        --used;
+    }
+
+    void set_reply_handler(ReplyHandler h, void* context = nullptr) {
+        handler = h;
+        handler_context = context;
+    }
+
+    void set_timeout_handler(TimeoutHandler h, void* context = nullptr) {
+        timeout_handler = h;
+        timeout_handler_context = context;
+    }
+
+    // (Re)register the next timer of the deck, e.g. after commands are sent to it
+    void schedule(const size_t i) {
+        if (i >= N || !entries[i].deck) return;
+        unlink(i);
+        const uint32_t now = Clock::micros();
+        const uint32_t due = entries[i].deck->next_event_us(now);
+        if (due == NO_TIMER) return;
+        link(i, slot_after(now, due));
+    }
+
+    void schedule_all() {
+        for (size_t i = 0; i < N; ++i) schedule(i);
+    }
+
+    // Wait up to `timeout_ms` for readable ports or timers, then service them.
+    // Returns the number of reply packets parsed, or -1 if epoll_wait failed.
+    int poll(const uint32_t timeout_ms) {
+        if (!valid()) return -1;
+        epoll_event events[(N < 64) ? N : 64];
+        const int timeout = wait_ms(timeout_ms);
+        const int n = ::epoll_wait(epfd, events, sizeof(events) / sizeof(events[0]), timeout);
+        if (n < 0 && errno != EINTR) {
+            LOG_ERROR("epoll_wait failed: errno", errno);
+            return -1;
+        }
+
+        int replies = 0;
+        for (int k = 0; k < n; ++k) {
+            const size_t i = events[k].data.u32;
+            if (i >= N || !entries[i].deck) continue;
+            if (events[k].events & (EPOLLERR | EPOLLHUP)) {
+                LOG_WARN("port of deck", i, "is closed, removed");
+                remove(i);
+                continue;
+            }
+            replies += service(i);
+        }
+        advance();
+        return replies;
+    }
+
+    size_t size() const { return used; }
+    ControllerType* deck(const size_t i) { return (i < N) ? entries[i].deck : nullptr; }
+
+private:
+    int service(const size_t i) {
+        ControllerType& d = *entries[i].deck;
+        int replies = 0;
+        while (d.parse()) {
+            ++replies;
+            if (handler) handler(i, d, handler_context);
+            if (!entries[i].deck) return replies;  // removed in the handler
+        }
+        schedule(i);
+        return replies;
+    }
+
+    // fire every slot up to now
+    void advance() {
+        const uint32_t now = Clock::micros();
+        if (scheduled == 0) {
+            wheel_us = now;
+            return;
+        }
+        for (size_t lap = 0; lap < SLOTS && (uint32_t)(now - wheel_us) >= TICK_US; ++lap) {
+            cursor = (cursor + 1) % SLOTS;
+            wheel_us += TICK_US;
+            fire(cursor);
+        }
+        // more than one lap behind: every slot has been fired once, so just catch up
+        if ((uint32_t)(now - wheel_us) >= TICK_US)
+            wheel_us = now;
+    }
+
+    // Rescheduled decks always go to the other slots, so taking the head until empty terminates
+    // even if the reply handler reschedules or removes the other decks.
+    void fire(const size_t slot) {
+        int16_t i;
+        while ((i = wheel[slot]) != NIL) {
+            unlink((size_t)i);
+            ControllerType& d = *entries[i].deck;
+            // update() pops the command in flight only when it has timed out
+            const size_t queued = d.queued();
+            d.update();
+            if (timeout_handler && d.queued() < queued) {
+                timeout_handler((size_t)i, d, timeout_handler_context);
+                if (!entries[i].deck) continue;  // removed in the handler
+            }
+            service((size_t)i);  // update() or the handler may have sent the next command; also reschedules
+        }
+    }
+
+    // epoll timeout: the caller's timeout or the first non-empty slot, whichever is earlier
+    int wait_ms(const uint32_t timeout_ms) const {
+        if (scheduled == 0) return (timeout_ms > 0x7FFFFFFF) ? 0x7FFFFFFF : (int)timeout_ms;
+        const uint32_t late = (uint32_t)(Clock::micros() - wheel_us);
+        for (size_t k = 1; k <= SLOTS; ++k) {
+            if (wheel[(cursor + k) % SLOTS] == NIL) continue;
+            const uint32_t until = k * TICK_US;
+            const uint32_t ms = (until > late) ? (until - late + TICK_US - 1) / TICK_US : 0;
+            return (int)((ms < timeout_ms) ? ms : timeout_ms);
+        }
+        return (int)((timeout_ms < SLOTS) ? timeout_ms : SLOTS);
+    }
+
+    // slot which is never earlier than `due_us` after `now`
+    size_t slot_after(const uint32_t now, const uint32_t due_us) const {
+        const uint64_t from_wheel = (uint64_t)(uint32_t)(now - wheel_us) + due_us;
+        uint64_t ticks = (from_wheel + TICK_US - 1) / TICK_US;
+        if (ticks == 0) ticks = 1;
+        if (ticks >= SLOTS) ticks = SLOTS - 1;
+        return (cursor + (size_t)ticks) % SLOTS;
+    }
+
+    void link(const size_t i, const size_t slot) {
+        Entry& e = entries[i];
+        e.slot = (int16_t)slot;
+        e.prev = NIL;
+        e.next = wheel[slot];
+        if (e.next != NIL) entries[e.next].prev = (int16_t)i;
+        wheel[slot] = (int16_t)i;
+        ++scheduled;
+    }
+
+    void unlink(const size_t i) {
+        Entry& e = entries[i];
+        if (e.slot == NIL) return;
+        if (e.prev != NIL)
+            entries[e.prev].next = e.next;
+        else
+            wheel[e.slot] = e.next;
+        if (e.next != NIL) entries[e.next].prev = e.prev;
+        e.slot = e.prev = e.next = NIL;
+        --scheduled;
+    }
+};
+
+template <size_t N>
+using DeckManager = BasicDeckManager<DefaultClock, N>;
+
+}  // namespace sony9pin
+
+#include <DebugLogRestoreState.h>
+
+#endif  // SONY9PINREMOTE_DECK_MANAGER_H
@@ -6,8 +6,10 @@
 #include <Arduino.h>
 #endif
 #include <stdint.h>
+#include <string.h>
 
 #include "Types.h"
+#include "Commands.h"
 
 #include <ArxTypeTraits.h>
 #include <ArxContainer.h>
@@ -21,42 +23,62 @@
 
 namespace sony9pin {
 
-#define SONY9PIN_RESPONSE_CHECK(c1, c2, sz, ret)        \
-    {                                                   \
-        bool is_success = true;                         \
-        if (!available()) {                             \
-            LOG_ERROR("No response available");         \
-            is_success = false;                         \
-        } else {                                        \
-            LOG_INFO(                                   \
-                DebugLogBase::HEX,                      \
-                "Response cmd1:", (uint8_t)cmd1(),      \
-                "cmd2:", cmd2(),                        \
-                "size:", size());                       \
-            if (!(cmd1() == c1) || !(cmd2() == c2)) {   \
-                LOG_ERROR(                              \
-                    DebugLogBase::HEX,                  \
-                    "Packet type mismatch:",            \
-                    (uint8_t)cmd1(), "!=", (uint8_t)c1, \
-                    "or",                               \
-                    cmd2(), "!=", c2);                  \
-                is_success = false;                     \
-            }                                           \
-            if (size() != sz) {                         \
-                LOG_ERROR(                              \
-                    DebugLogBase::DEC,                  \
-                    "Packet size not correct:",         \
-                    size(), "should be", sz);           \
-                is_success = false;                     \
-            }                                           \
-        }                                               \
-        if (!is_success) return ret;                    \
-    }
+// The data size is taken from the reply table (see Commands.h).
+// Only the replies whose size is variable there give the size of the layout they decode.
+#define SONY9PIN_RESPONSE_CHECK(c1, c2, ret) \
+    SONY9PIN_RESPONSE_CHECK_SIZE(c1, c2, reply_info((uint8_t)(c1), c2).size, ret)
+
+#define SONY9PIN_RESPONSE_CHECK_SIZE(c1, c2, sz, ret)    \
+    {                                                    \
+        bool is_success = true;                          \
+        if (!available()) {                              \
+            LOG_ERROR("No response available");          \
+            is_success = false;                          \
+        } else {                                         \
+            LOG_INFO(                                    \
+                DebugLogBase::HEX,                       \
+                "Response cmd1:", (uint8_t)cmd1(),       \
+                "cmd2:", cmd2(),                         \
+                "size:", size());                        \
+            if (!(cmd1() == c1) || !(cmd2() == c2)) {    \
+                LOG_ERROR(                               \
+                    DebugLogBase::HEX,                   \
+                    "Packet type mismatch:",             \
+                    (uint8_t)cmd1(), "!=", (uint8_t)c1,  \
+                    "or",                                \
+                    cmd2(), "!=", c2);                   \
+                is_success = false;                      \
+            }                                            \
+            if ((sz != VARIABLE_SIZE) && size() != sz) { \
+                LOG_ERROR(                               \
+                    DebugLogBase::DEC,                   \
+                    "Packet size not correct:",          \
+                    size(), "should be", sz);            \
+                is_success = false;                      \
+            }                                            \
+        }                                                \
+        if (!is_success) return ret;                     \
+    }
+
+struct FeedResult {
+    size_t consumed {0};  // number of bytes consumed
+    size_t packets {0};   // number of packets completed
+};
 
 class Decoder {
     uint8_t buffer[MAX_PACKET_SIZE];
     uint8_t next_size {0};
     uint8_t curr_size {0};
+    uint8_t crc {0};  // running checksum of the bytes received so far
+
+    bool b_resync {false};
+    bool b_commands {false};
+    uint8_t rescan[MAX_PACKET_SIZE * 2];
+    uint8_t rescan_begin {0};
+    uint8_t rescan_end {0};
+    size_t n_packets {0};
+    size_t n_recovered {0};
+    size_t n_lost {0};
 
 public:
     bool available() const {
@@ -87,49 +109,108 @@ public:
     }
 
     void clear() {
-        memset(buffer, 0, MAX_PACKET_SIZE);
         next_size = 0;
         curr_size = 0;
+        crc = 0;
     }
 
-    bool feed(const uint8_t d) {
-        if (curr_size >= next_size) {  // next or unexpected response
-            clear();
-        }
+    // clear the current packet and also the bytes waiting for rescan
+    void reset() {
+        clear();
+        rescan_begin = rescan_end = 0;
+    }
 
-        if (next_size == 0) {  // header byte
-            uint8_t type = d & (uint8_t)HeaderMask::CMD1;
-            uint8_t size = d & (uint8_t)HeaderMask::SIZE;
+    bool feed(const uint8_t d) {
+        if (rescan_begin == rescan_end) {
+            const FeedState state = feed_byte(d);
+            if (state == FeedState::PACKET) return true;
+            if (state == FeedState::NONE) return false;
 
-            if ((type == (uint8_t)Cmd1::SYSTEM_CONTROL_RETURN) ||
-                (type == (uint8_t)Cmd1::SENSE_RETURN)) {
-                next_size = size + 3;  // header + cmd2 + size + checksum
-                buffer[curr_size++] = d;
-            } else {  // this is not response headr
-                LOG_ERROR(DebugLogBase::HEX, "Packet is not response:", type);
+            ++n_lost;
+            if (!b_resync) {
                 clear();
+                return false;
             }
-        } else if (curr_size < next_size) {
-            buffer[curr_size++] = d;
-
-            if (curr_size == next_size) {
-                uint8_t checksum = 0;
-                for (uint8_t i = 0; i < curr_size - 1; ++i)
-                    checksum += buffer[i];
-
-                if (d == checksum) {
-                    return true;
-                } else {
-                    LOG_ERROR(DebugLogBase::HEX, "Checksum not matched:", checksum, "should be", d);
-                    clear();
+            // the packet is broken but the bytes after its header may contain the next one
+            rescan_end = curr_size - 1;
+            memcpy(rescan, buffer + 1, rescan_end);
+            clear();
+        } else {
+            if (rescan_end == sizeof(rescan)) compact_rescan();
+            rescan[rescan_end++] = d;
+        }
+        return drain_rescan();
+    }
+
+    // Feed a block of bytes.
+    // If `stop_at_packet` is true, stops just after the first completed packet so that it can be
+    // read before the remaining bytes (data + result.consumed) are fed.
+    // Otherwise all bytes are consumed and only the last completed packet remains available.
+    // Packets still waiting in the rescan buffer (see `pending()`) are completed first,
+    // so feeding an empty block drains them.
+    FeedResult feed(const uint8_t* data, const size_t size, const bool stop_at_packet = true) {
+        FeedResult result;
+        while (pending()) {
+            if (drain_rescan()) {
+                ++result.packets;
+                if (stop_at_packet) return result;
+            }
+        }
+        while (result.consumed < size) {
+            if (busy() && (rescan_begin == rescan_end)) {
+                // copy payload bytes in bulk until the checksum byte
+                const size_t remaining = size - result.consumed;
+                size_t n = next_size - 1 - curr_size;
+                if (n > remaining) n = remaining;
+                for (const uint8_t* p = data + result.consumed; p != data + result.consumed + n; ++p) {
+                    buffer[curr_size++] = *p;
+                    crc += *p;
                 }
+                result.consumed += n;
+                if (result.consumed == size) break;
+            }
+            if (feed(data[result.consumed++])) {
+                ++result.packets;
+                if (stop_at_packet) return result;
             }
-        } else {
-            LOG_ERROR("Unexpected: won't come here");
-            clear();
         }
+        while (pending()) {
+            if (drain_rescan()) ++result.packets;
+        }
+        return result;
+    }
 
-        return false;
+    // True if bytes received after a broken packet are still waiting to be rescanned.
+    // A resync can recover several packets from them at once, but `feed()` returns at each one,
+    // so keep feeding (an empty block is enough) until this turns false.
+    bool pending() const {
+        return rescan_begin < rescan_end;
+    }
+
+    // Resync mode: when a checksum mismatch is detected, the bytes received after the broken
+    // packet's header are rescanned for the next plausible reply header instead of being dropped.
+    // So one corrupted byte costs only the packet which contains it.
+    void enable_resync(const bool b = true) {
+        b_resync = b;
+    }
+    bool is_resync_enabled() const {
+        return b_resync;
+    }
+
+    // Device-side mode: accept the commands from the controller (0x00, 0x20, 0x40, 0x60, 0x80, 0xA0)
+    // instead of the replies from the device. Used by `VirtualDeck`.
+    void accept_commands(const bool b = true) {
+        b_commands = b;
+    }
+    bool is_accepting_commands() const {
+        return b_commands;
+    }
+
+    size_t packet_count() const { return n_packets; }      // packets completed
+    size_t recovered_count() const { return n_recovered; }  // packets completed from rescanned bytes
+    size_t lost_count() const { return n_lost; }            // broken packets dropped by checksum mismatch
+    void reset_counts() {
+        n_packets = n_recovered = n_lost = 0;
     }
 
     // =============== 1 - System Control Return ===============
@@ -140,7 +221,7 @@ public:
     // it does not necessarily mean that the command was completed and the device is
     // in the required state.
     bool ack() const {
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::ACK, 0, false);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::ACK, false);
         return true;
     }
 
@@ -167,7 +248,7 @@ public:
     //     or a checksum is sent too late.
     Errors nak() const {
         Errors errs;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::NAK, 1, errs);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::NAK, errs);
         errs.b_unknown_cmd = buffer[2] & NakMask::UNKNOWN_CMD;
         errs.b_checksum_error = buffer[2] & NakMask::CHECKSUM_ERROR;
         errs.b_parity_error = buffer[2] & NakMask::PARITY_ERROR;
@@ -189,7 +270,7 @@ public:
     // Sony PVW-2800      20     41
     uint16_t device_type() const {
         uint16_t dev_no = 0xFFFF;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::DEVICE_TYPE, 2, dev_no);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::DEVICE_TYPE, dev_no);
         dev_no = ((uint16_t)buffer[2] << 8) | (uint16_t)buffer[3];
         return dev_no;
     }
@@ -204,9 +285,9 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command and U - BIT PRESET.
     TimeCodeAndUserBits gen_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::GEN_TC_UB, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::GEN_TC_UB, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
 
@@ -215,7 +296,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command.
     TimeCode gen_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::GEN_TC, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::GEN_TC, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -225,7 +306,7 @@ public:
     // For the data format, refer to the U-BIT PRESET.
     UserBits gen_ub() const {
         UserBits ub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::GEN_UB, 4, ub);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::GEN_UB, ub);
         decode_to_userbits(ub);
         return ub;
     }
@@ -245,20 +326,25 @@ public:
     // When the device receives the CURRENT TIME SENSE 61.0C command, and has been set to
     // the CG mode, the device will be set to 1.
 
-    /// Generic response for timecode + userbits without packet check
+    /// Generic response for timecode + userbits without the cmd1 / cmd2 check.
+    /// Only the data size is checked, and an empty value is returned if the reply is shorter,
+    /// because the buffer is not cleared between packets.
     TimeCodeAndUserBits timecode_userbits() const {
         TimeCodeAndUserBits tcub;
+        if (size() != TIMECODE_USERBITS_SIZE) return tcub;
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
     TimeCode timecode() const {
         TimeCode tc;
+        if (size() < TIMECODE_SIZE) return tc;
         decode_to_timecode(tc);
         return tc;
     }
     UserBits userbits() const {
         UserBits ub;
+        if (size() < sizeof(UserBits)) return ub;
         decode_to_userbits(ub);
         return ub;
     }
@@ -269,14 +355,14 @@ public:
     // refer to the CUE UP WITH DATA command.
     TimeCodeAndUserBits timer1_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::TIMER_1, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::TIMER_1, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
     TimeCode timer1_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::TIMER_1, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::TIMER_1, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -287,14 +373,14 @@ public:
     // refer to the CUE UP WITH DATA command.
     TimeCodeAndUserBits timer2_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::TIMER_2, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::TIMER_2, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
     TimeCode timer2_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::TIMER_2, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::TIMER_2, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -305,9 +391,9 @@ public:
     // refer to the CUE UP WITH DATA and U-BIT PRESET command.
     TimeCodeAndUserBits ltc_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_TC_UB, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::LTC_TC_UB, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
 
@@ -317,7 +403,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command.
     TimeCode ltc_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_TC, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::LTC_TC, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -326,7 +412,7 @@ public:
     // Returned with the LTC UB DATA. For the data format, refer to the U-BIT PRESET 44.05 command.
     UserBits ltc_ub() const {
         UserBits ub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_UB, 4, ub);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_UB, ub);
         decode_to_userbits(ub);
         return ub;
     }
@@ -337,9 +423,9 @@ public:
     // For the data format, refer to the CUE UP WITH DATA and U-BIT PRESET command.
     TimeCodeAndUserBits vitc_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::VITC_TC_UB, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::VITC_TC_UB, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
 
@@ -348,7 +434,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA 24.31 command.
     TimeCode vitc_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::VITC_TC, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::VITC_TC, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -356,7 +442,7 @@ public:
     // 74.07 ITC TIME DATA
     UserBits vitc_ub() const {
         UserBits ub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::VITC_UB, 4, ub);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::VITC_UB, ub);
         decode_to_userbits(ub);
         return ub;
     }
@@ -369,9 +455,9 @@ public:
     // For the data format, refer to the CUE UP WITH DATA and U-BIT PRESET command.
     TimeCodeAndUserBits ltc_interpolated_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_TC_UB, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_TC_UB, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
 
@@ -382,7 +468,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command.
     TimeCode ltc_interpolated_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_TC, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_TC, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -390,7 +476,7 @@ public:
     // 74.15 LTC TIME UB
     UserBits ltc_interpolated_ub() const {
         UserBits ub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_UB, 4, ub);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::LTC_INTERPOLATED_UB, ub);
         decode_to_userbits(ub);
         return ub;
     }
@@ -402,9 +488,9 @@ public:
     // For the data format, refer to the CUE UP WITH DATA and U-BIT PRESET command.
     TimeCodeAndUserBits hold_vitc_tc_ub() const {
         TimeCodeAndUserBits tcub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::HOLD_VITC_TC_UB, 8, tcub);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::HOLD_VITC_TC_UB, TIMECODE_USERBITS_SIZE, tcub);
         decode_to_timecode(tcub.tc);
-        decode_to_userbits(tcub.ub);
+        decode_to_userbits(tcub.ub, TIMECODE_SIZE);
         return tcub;
     }
 
@@ -414,7 +500,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command.
     TimeCode hold_vitc_tc() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::HOLD_VITC_TC, 4, tc);
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::HOLD_VITC_TC, TIMECODE_SIZE, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -422,7 +508,7 @@ public:
     // 74.17 VITC HOLD UB
     UserBits hold_vitc_ub() const {
         UserBits ub;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::HOLD_VITC_UB, 4, ub);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::HOLD_VITC_UB, ub);
         decode_to_userbits(ub);
         return ub;
     }
@@ -434,7 +520,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command.
     TimeCode in_data() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::IN_DATA, 4, tc);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::IN_DATA, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -444,7 +530,7 @@ public:
     // For the data format, refer to the CUE UP WITH DATA command.
     TimeCode out_data() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::OUT_DATA, 4, tc);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::OUT_DATA, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -551,109 +637,17 @@ public:
     // Set to 1 if the device has reached the end of its media.
     // BIT-5 NEAR END
     // Set to 1 if the device is near the end of its media.
-    Status status_sense(const uint8_t start = 0, const uint8_t sz = 10) const {
-        Status sts;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::STATUS_DATA, sz, sts);
-        for (uint8_t i = start; i < start + sz; ++i) {
-            size_t idx = 2 + i - start;
-            switch (i) {
-                case 0: {  // byte 0
-                    sts.b_cassette_out = buffer[idx] & StatusMask::CASSETTE_OUT;
-                    sts.b_servo_ref_missing = buffer[idx] & StatusMask::SERVO_REF_MISSING;
-                    sts.b_local = buffer[idx] & StatusMask::LOCAL;
-                    break;
-                }
-                case 1: {  // byte 1
-                    sts.b_standby = buffer[idx] & StatusMask::STANDBY;
-                    sts.b_stop = buffer[idx] & StatusMask::STOP;
-                    sts.b_eject = buffer[idx] & StatusMask::EJECT;
-                    sts.b_rewind = buffer[idx] & StatusMask::REWIND;
-                    sts.b_forward = buffer[idx] & StatusMask::FORWARD;
-                    sts.b_record = buffer[idx] & StatusMask::RECORD;
-                    sts.b_play = buffer[idx] & StatusMask::PLAY;
-                    break;
-                }
-                case 2: {  // byte 2
-                    sts.b_servo_lock = buffer[idx] & StatusMask::SERVO_LOCK;
-                    sts.b_tso_mode = buffer[idx] & StatusMask::TSO_MODE;
-                    sts.b_shuttle = buffer[idx] & StatusMask::SHUTTLE;
-                    sts.b_jog = buffer[idx] & StatusMask::JOG;
-                    sts.b_var = buffer[idx] & StatusMask::VAR;
-                    sts.b_direction = buffer[idx] & StatusMask::DIRECTION;
-                    sts.b_still = buffer[idx] & StatusMask::STILL;
-                    sts.b_cue_up = buffer[idx] & StatusMask::CUE_UP;
-                    break;
-                }
-                case 3: {  // byte 3
-                    sts.b_auto_mode = buffer[idx] & StatusMask::AUTO_MODE;
-                    sts.b_freeze_on = buffer[idx] & StatusMask::FREEZE_ON;
-                    sts.b_cf_mode = buffer[idx] & StatusMask::CF_MODE;
-                    sts.b_audio_out_set = buffer[idx] & StatusMask::AUDIO_OUT_SET;
-                    sts.b_audio_in_set = buffer[idx] & StatusMask::AUDIO_IN_SET;
-                    sts.b_out_set = buffer[idx] & StatusMask::OUT_SET;
-                    sts.b_in_set = buffer[idx] & StatusMask::IN_SET;
-                    break;
-                }
-                case 4: {  // byte 4
-                    sts.b_select_ee = buffer[idx] & StatusMask::SELECT_EE;
-                    sts.b_full_ee = buffer[idx] & StatusMask::FULL_EE;
-                    sts.b_edit = buffer[idx] & StatusMask::EDIT_SET;
-                    sts.b_review = buffer[idx] & StatusMask::REVIEW_SET;
-                    sts.b_auto_edit = buffer[idx] & StatusMask::AUTO_EDIT_SET;
-                    sts.b_preview = buffer[idx] & StatusMask::PREVIEW_SET;
-                    sts.b_preroll = buffer[idx] & StatusMask::PREROLL_SET;
-                    break;
-                }
-                case 5: {  // byte 5
-                    sts.b_insert = buffer[idx] & StatusMask::INSERT_SET;
-                    sts.b_assemble = buffer[idx] & StatusMask::ASSEMBLE_SET;
-                    sts.b_video = buffer[idx] & StatusMask::VIDEO_SET;
-                    sts.b_a4 = buffer[idx] & StatusMask::A4_SET;
-                    sts.b_a3 = buffer[idx] & StatusMask::A3_SET;
-                    sts.b_a2 = buffer[idx] & StatusMask::A2_SET;
-                    sts.b_a1 = buffer[idx] & StatusMask::A1_SET;
-                    break;
-                }
-                case 6: {  // byte 6
-                    sts.b_lamp_still = buffer[idx] & StatusMask::LAMP_STILL;
-                    sts.b_lamp_fwd = buffer[idx] & StatusMask::LAMP_FWD;
-                    sts.b_lamp_rev = buffer[idx] & StatusMask::LAMP_REV;
-                    sts.b_srch_led_8 = buffer[idx] & StatusMask::SRCH_LED_8;
-                    sts.b_srch_led_4 = buffer[idx] & StatusMask::SRCH_LED_4;
-                    sts.b_srch_led_2 = buffer[idx] & StatusMask::SRCH_LED_2;
-                    sts.b_srch_led_1 = buffer[idx] & StatusMask::SRCH_LED_1;
-                    break;
-                }
-                case 7: {  // byte 8
-                    sts.b_aud_split = buffer[idx] & StatusMask::AUD_SPLIT;
-                    sts.b_sync_act = buffer[idx] & StatusMask::SYNC_ACT;
-                    sts.b_spot_erase = buffer[idx] & StatusMask::SPOT_ERASE;
-                    sts.b_in_out = buffer[idx] & StatusMask::IN_OUT;
-                    break;
-                }
-                case 8: {  // byte 8
-                    sts.b_buzzer = buffer[idx] & StatusMask::BUZZER;
-                    sts.b_lost_lock = buffer[idx] & StatusMask::LOST_LOCK;
-                    sts.b_near_eot = buffer[idx] & StatusMask::NEAR_EOT;
-                    sts.b_eot = buffer[idx] & StatusMask::EOT;
-                    sts.b_cf_lock = buffer[idx] & StatusMask::CF_LOCK;
-                    sts.b_svo_alarm = buffer[idx] & StatusMask::SVO_ALARM;
-                    sts.b_sys_alarm = buffer[idx] & StatusMask::SYS_ALARM;
-                    sts.b_rec_inhib = buffer[idx] & StatusMask::REC_INHIB;
-                    break;
-                }
-                case 9: {  // byte 9
-                    sts.b_fnc_abort = buffer[idx] & StatusMask::FNC_ABORT;
-                    break;
-                }
-                default: {
-                    break;
-                }
-            }
-        }
-
+    RawStatus raw_status_sense(const uint8_t start = 0, const uint8_t sz = 10) const {
+        RawStatus sts;
+        SONY9PIN_RESPONSE_CHECK_SIZE(Cmd1::SENSE_RETURN, SenseReturn::STATUS_DATA, sz, sts);
+        // bytes out of the requested range are left cleared
+        for (uint8_t i = start; (i < start + sz) && (i < RawStatus::SIZE); ++i)
+            sts.bytes[i] = buffer[2 + i - start];
         return sts;
     }
+    Status status_sense(const uint8_t start = 0, const uint8_t sz = 10) const {
+        return raw_status_sense(start, sz).to_status();
+    }
 
     // 60.30 PRE-ROLL TIME
     // This command is used for requesting the current pre-roll duration.
@@ -662,7 +656,7 @@ public:
     // Returns: 74 30 00 05 00 00 A9 (Pre-roll is five seconds)
     TimeCode preroll_time() const {
         TimeCode tc;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::PREROLL_TIME, 4, tc);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::PREROLL_TIME, tc);
         decode_to_timecode(tc);
         return tc;
     }
@@ -671,7 +665,7 @@ public:
     // Refer to the TIMER MODE SENSE command.
     TimerMode timer_mode() const {
         TimerMode tm = TimerMode::NA;
-        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::TIMER_MODE_STATUS, 1, tm);
+        SONY9PIN_RESPONSE_CHECK(Cmd1::SENSE_RETURN, SenseReturn::TIMER_MODE_STATUS, tm);
         switch (buffer[2]) {
             case 0x00: tm = TimerMode::TIME_CODE; break;
             case 0x01: tm = TimerMode::CTL_COUNTER; break;
@@ -681,10 +675,91 @@ public:
     }
 
 private:
-    template <typename T>
-    inline auto from_bcd_to_dec(const T& n) const
-        -> typename std::enable_if<std::is_integral<T>::value, size_t>::type {
-        return n - 6 * (n >> 4);
+    enum class FeedState : uint8_t {
+        NONE,
+        PACKET,
+        CORRUPTED,
+    };
+
+    FeedState feed_byte(const uint8_t d) {
+        if (curr_size >= next_size) {  // next or unexpected response
+            clear();
+        }
+
+        if (next_size == 0) {  // header byte
+            if (is_header(d)) {
+                next_size = (d & (uint8_t)HeaderMask::SIZE) + 3;  // header + cmd2 + size + checksum
+                buffer[curr_size++] = d;
+                crc = d;
+            } else {  // this is not response headr
+                LOG_ERROR(DebugLogBase::HEX, "Packet is not expected type:", (uint8_t)(d & (uint8_t)HeaderMask::CMD1));
+            }
+        } else {
+            buffer[curr_size++] = d;
+            if (curr_size < next_size) {
+                crc += d;
+            } else if (d == crc) {
+                ++n_packets;
+                return FeedState::PACKET;
+            } else {
+                LOG_ERROR(DebugLogBase::HEX, "Checksum not matched:", crc, "should be", d);
+                return FeedState::CORRUPTED;
+            }
+        }
+        return FeedState::NONE;
+    }
+
+    bool is_header(const uint8_t d) const {
+        const uint8_t type = d & (uint8_t)HeaderMask::CMD1;
+        if (b_commands) {
+            switch (type) {
+                case (uint8_t)Cmd1::SYSTEM_CONTROL:
+                case (uint8_t)Cmd1::TRANSPORT_CONTROL:
+                case (uint8_t)Cmd1::PRESET_SELECT_CONTROL:
+                case (uint8_t)Cmd1::SENSE_REQUEST:
+                case (uint8_t)Cmd1::BMD_EXTENSION:
+                case (uint8_t)Cmd1::BMD_ADVANCED_MEDIA_PRTCL:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        if (type == (uint8_t)Cmd1::SENSE_RETURN) return true;
+        if (type != (uint8_t)Cmd1::SYSTEM_CONTROL_RETURN) return false;
+        // whenever resync is enabled (normal framing and rescanning alike), also check the size:
+        // ACK, NAK and DEVICE TYPE have at most 2 data bytes
+        return !b_resync || ((d & (uint8_t)HeaderMask::SIZE) <= 2);
+    }
+
+    // While rescan buffer is not empty, all bytes are fed through it.
+    // Then the bytes of the current (incomplete) packet are always rescan[rescan_begin - curr_size, rescan_begin).
+    bool drain_rescan() {
+        while (rescan_begin < rescan_end) {
+            const FeedState state = feed_byte(rescan[rescan_begin++]);
+            if (state == FeedState::PACKET) {
+                ++n_recovered;
+                return true;
+            } else if (state == FeedState::CORRUPTED) {
+                // false candidate found while rescanning, not counted as lost
+                rescan_begin -= curr_size - 1;
+                clear();
+            }
+        }
+        rescan_begin = rescan_end = 0;
+        return false;
+    }
+
+    void compact_rescan() {
+        const uint8_t from = (rescan_begin >= curr_size) ? rescan_begin - curr_size : 0;
+        if (from == 0) {  // should not happen, but never overflow
+            LOG_ERROR("Rescan buffer overflow");
+            ++n_lost;
+            reset();
+            return;
+        }
+        memmove(rescan, rescan + from, rescan_end - from);
+        rescan_begin -= from;
+        rescan_end -= from;
     }
 
     bool empty() const {
@@ -692,12 +767,7 @@ private:
     }
 
     void decode_to_timecode(TimeCode& tc) const {
-        tc.is_cf = buffer[2] & 0b10000000;
-        tc.is_df = buffer[2] & 0b01000000;
-        tc.frame = from_bcd_to_dec(buffer[2] & 0x3F);
-        tc.second = from_bcd_to_dec(buffer[3] & 0x7F);
-        tc.minute = from_bcd_to_dec(buffer[4] & 0x7F);
-        tc.hour = from_bcd_to_dec(buffer[5] & 0x3F);
+        tc = TimeCode::decode_bcd(buffer + 2);
     }
 
     void decode_to_userbits(UserBits& ub, const size_t offset = 0) const {
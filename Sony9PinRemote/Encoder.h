@@ -3,6 +3,7 @@
 #define SONY9PINREMOTE_ENCODER_H
 
 #include "Types.h"
+#include "Commands.h"
 #include <ArxTypeTraits.h>
 #include <ArxContainer.h>
 #include <DebugLog.h>
@@ -33,10 +34,40 @@ namespace util {
     }
 }  // namespace util
 
+// Fixed-capacity packet storage with the subset of std::vector API used by Encoder/Controller.
+// No packet can exceed MAX_PACKET_SIZE, so hosted builds keep the bytes inline instead of on heap.
+class PacketBuffer {
+    uint8_t buf[MAX_PACKET_SIZE];
+    uint8_t sz {0};
+
+public:
+    void emplace_back(const uint8_t v) {
+        if (sz < MAX_PACKET_SIZE)
+            buf[sz++] = v;
+        else
+            LOG_ERROR("Packet size exceeds MAX_PACKET_SIZE");
+    }
+    void push_back(const uint8_t v) { emplace_back(v); }
+    void clear() { sz = 0; }
+
+    uint8_t* data() { return buf; }
+    const uint8_t* data() const { return buf; }
+    size_t size() const { return sz; }
+    bool empty() const { return sz == 0; }
+    static constexpr size_t capacity() { return MAX_PACKET_SIZE; }
+
+    uint8_t& operator[](const size_t i) { return buf[i]; }
+    const uint8_t& operator[](const size_t i) const { return buf[i]; }
+    uint8_t* begin() { return buf; }
+    uint8_t* end() { return buf + sz; }
+    const uint8_t* begin() const { return buf; }
+    const uint8_t* end() const { return buf + sz; }
+};
+
 class Encoder {
 public:
 #if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
-    using Packet = std::vector<uint8_t>;
+    using Packet = PacketBuffer;
 #else   // Do not have libstdc++11
     using Packet = arx::stdx::vector<uint8_t, MAX_PACKET_SIZE>;
 #endif  // Do not have libstdc++11
@@ -282,10 +313,18 @@ public:
     // Returns: 10 01 11
     // Send: 24 24 36 52 21 F1 (Cue to 21 hours, 52 minutes, 36 seconds, 24 frames)
     // Returns: 10 01 11
+    // NOTE: this overload sends hh, mm, ss, ff as they are (they must be BCD already, e.g. 0x13 for 13),
+    // while the TimeCode overload below encodes the decimal fields to BCD.
+    // The same time therefore needs different arguments for the two overloads.
     Packet cue_up_with_data(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
         LOG_INFO(" ");
         return encode(Cmd1::TRANSPORT_CONTROL, TransportCtrl::CUE_UP_WITH_DATA, ff, ss, mm, hh);
     }
+    // TimeCode is encoded to BCD (DF flag is set to BIT-6 of DATA-1)
+    Packet cue_up_with_data(const TimeCode& tc) {
+        LOG_INFO(" ");
+        return encode_timecode(Cmd1::TRANSPORT_CONTROL, TransportCtrl::CUE_UP_WITH_DATA, tc);
+    }
 
     // 20.34 Sync Play
     // UNKNOWN
@@ -489,6 +528,9 @@ public:
         f |= (uint8_t)is_df << 6;  // 0: non-drop, 1: drop
         return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::TIMER_1_PRESET, f, s, m, h);
     }
+    Packet timer1_preset(const TimeCode& tc) {
+        return timer1_preset(tc.hour, tc.minute, tc.second, tc.frame, tc.is_df);
+    }
 
     // 44.04 TIME CODE PRESET
     // Presets the value, given by DATA-1 to DATA-4, to the time code start of the PRESET time code
@@ -508,6 +550,9 @@ public:
         f |= (uint8_t)is_df << 6;  // 0: non-drop, 1: drop
         return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::TIME_CODE_PRESET, f, s, m, h);
     }
+    Packet time_code_preset(const TimeCode& tc) {
+        return time_code_preset(tc.hour, tc.minute, tc.second, tc.frame, tc.is_df);
+    }
 
     // 44.05 USER-BIT PRESET
     // Presets the user bit values in the time code recording of the device, if the device supports
@@ -582,6 +627,11 @@ public:
         // f |= (uint8_t)is_df << 6;  // 0: non-drop, 1: drop
         return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_DATA_PRESET, f, s, m, h);
     }
+    // TimeCode is encoded to BCD (DF flag is set to BIT-6 of DATA-1 as CUE UP WITH DATA)
+    Packet in_data_preset(const TimeCode& tc) {
+        LOG_INFO(" ");
+        return encode_timecode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_DATA_PRESET, tc);
+    }
 
     // 44.15 OUT PRESET
     // Set the out point for the next edit to the time specified by DATA-1 through DATA-4.
@@ -597,6 +647,11 @@ public:
         // f |= (uint8_t)is_df << 6;  // 0: non-drop, 1: drop
         return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_DATA_PRESET, f, s, m, h);
     }
+    // TimeCode is encoded to BCD (DF flag is set to BIT-6 of DATA-1 as CUE UP WITH DATA)
+    Packet out_data_preset(const TimeCode& tc) {
+        LOG_INFO(" ");
+        return encode_timecode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_DATA_PRESET, tc);
+    }
 
     // 4?.16 Audio In Data Preset
     // UNKNOWN
@@ -801,6 +856,11 @@ public:
         // f |= (uint8_t)is_df << 6;  // 0: non-drop, 1: drop
         return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::PREROLL_PRESET, f, s, m, h);
     }
+    // TimeCode is encoded to BCD (DF flag is set to BIT-6 of DATA-1 as CUE UP WITH DATA)
+    Packet preroll_preset(const TimeCode& tc) {
+        LOG_INFO(" ");
+        return encode_timecode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::PREROLL_PRESET, tc);
+    }
 
     // 41.32 Tape/Audio Select
     // UNKNOWN
@@ -930,7 +990,7 @@ public:
     // REPLY: ACK
     Packet audio_split_on() {
         LOG_INFO(" ");
-        return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_SPLIT_OFF);
+        return encode(Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_SPLIT_ON);
     }
 
     // 4X.98 Output H Phase
@@ -1400,6 +1460,10 @@ private:
         uint8_t size = sizeof...(args);
         uint8_t header = (uint8_t)cmd1 | (size & 0x0F);
         uint8_t crc = header + (uint8_t)cmd2;
+#ifdef SONY9PINREMOTE_DEBUGLOG_ENABLE
+        if (!command_info(header, (uint8_t)cmd2).accepts(size))
+            LOG_WARN(DebugLogBase::HEX, "data size does not match the command table:", header, (uint8_t)cmd2);
+#endif
         Packet packet;
         packet.emplace_back(header);
         packet.emplace_back((uint8_t)cmd2);
@@ -1411,6 +1475,15 @@ private:
         return encode(packet, crc, util::forward<Args>(args)...);
     }
 
+    // DATA-1 to DATA-4 of the CUE UP WITH DATA format: frames, seconds, minutes, hours in BCD
+    // (DF flag is set to BIT-6 of DATA-1)
+    template <typename Cmd2>
+    Packet encode_timecode(const Cmd1 cmd1, const Cmd2 cmd2, const TimeCode& tc) {
+        uint8_t f = from_dec_to_bcd(tc.frame);
+        f |= (uint8_t)tc.is_df << 6;
+        return encode(cmd1, cmd2, f, from_dec_to_bcd(tc.second), from_dec_to_bcd(tc.minute), from_dec_to_bcd(tc.hour));
+    }
+
     template <typename T>
     inline auto from_dec_to_bcd(const T& n)
         -> typename std::enable_if<std::is_integral<T>::value, size_t>::type {
@@ -1418,6 +1491,122 @@ private:
     }
 };
 
+// =============== Prebuilt Packets ===============
+//
+// Fully encoded frames (header, cmd2, data and checksum) of the commands which take no
+// runtime argument. They are built at compile time and live in read-only memory,
+// so sending one of them is a single write of a constant buffer without any encoding work.
+// e.g. `stream.write(prebuilt::stop::data, prebuilt::stop::size);`
+
+namespace util {
+    constexpr uint8_t checksum() {
+        return 0;
+    }
+    template <typename... Args>
+    constexpr uint8_t checksum(const uint8_t v, Args... args) {
+        return (uint8_t)(v + checksum(args...));
+    }
+}  // namespace util
+
+template <Cmd1 C1, uint8_t C2, uint8_t... Data>
+struct PrebuiltPacket {
+    static constexpr uint8_t header {(uint8_t)((uint8_t)C1 | (sizeof...(Data) & 0x0F))};
+    static constexpr uint8_t size {(uint8_t)(sizeof...(Data) + 3)};
+    static constexpr uint8_t data[sizeof...(Data) + 3] {header, C2, Data..., util::checksum(header, C2, Data...)};
+};
+template <Cmd1 C1, uint8_t C2, uint8_t... Data>
+constexpr uint8_t PrebuiltPacket<C1, C2, Data...>::header;
+template <Cmd1 C1, uint8_t C2, uint8_t... Data>
+constexpr uint8_t PrebuiltPacket<C1, C2, Data...>::size;
+template <Cmd1 C1, uint8_t C2, uint8_t... Data>
+constexpr uint8_t PrebuiltPacket<C1, C2, Data...>::data[sizeof...(Data) + 3];
+
+namespace prebuilt {
+    // 0 - System Control
+    using local_disable = PrebuiltPacket<Cmd1::SYSTEM_CONTROL, SystemCtrl::LOCAL_DISABLE>;
+    using device_type_request = PrebuiltPacket<Cmd1::SYSTEM_CONTROL, SystemCtrl::DEVICE_TYPE>;
+    using local_enable = PrebuiltPacket<Cmd1::SYSTEM_CONTROL, SystemCtrl::LOCAL_ENABLE>;
+    // 2 - Transport Control
+    using stop = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::STOP>;
+    using play = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::PLAY>;
+    using record = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::RECORD>;
+    using standby_off = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::STANDBY_OFF>;
+    using standby_on = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::STANDBY_ON>;
+    using eject = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::EJECT>;
+    using fast_forward = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FAST_FWD>;
+    using frame_step_forward = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FRAME_STEP_FWD>;
+    using fast_reverse = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FAST_REVERSE>;
+    using rewind = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::REWIND>;
+    using frame_step_reverse = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FRAME_STEP_REV>;
+    using preroll = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::PREROLL>;
+    using sync_play = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::SYNC_PLAY>;
+    using preview = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::PREVIEW>;
+    using review = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::REVIEW>;
+    using auto_edit = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::AUTO_EDIT>;
+    using outpoint_preview = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::OUTPOINT_PREVIEW>;
+    using full_ee_off = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FULL_EE_OFF>;
+    using full_ee_on = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FULL_EE_ON>;
+    using select_ee_on = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::SELECT_EE_ON>;
+    using edit_off = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::EDIT_OFF>;
+    using edit_on = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::EDIT_ON>;
+    using freeze_off = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FREEZE_OFF>;
+    using freeze_on = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::FREEZE_ON>;
+    // 4 - Preset/Select Control
+    using timer1_reset = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::TIMER_1_RESET>;
+    using in_entry = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_ENTRY>;
+    using out_entry = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_ENTRY>;
+    using in_shift_plus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_SHIFT_PLUS>;
+    using in_shift_minus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_SHIFT_MINUS>;
+    using out_shift_plus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_SHIFT_PLUS>;
+    using out_shift_minus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_SHIFT_MINUS>;
+    using audio_in_shift_plus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_SHIFT_PLUS>;
+    using audio_in_shift_minus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_SHIFT_MINUS>;
+    using audio_out_shift_plus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_SHIFT_PLUS>;
+    using audio_out_shift_minus = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_SHIFT_MINUS>;
+    using in_flag_reset = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_FLAG_RESET>;
+    using out_flag_reset = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_FLAG_RESET>;
+    using audio_in_flag_reset = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_FLAG_RESET>;
+    using audio_out_flag_reset = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_FLAG_RESET>;
+    using in_recall = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::IN_RECALL>;
+    using out_recall = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::OUT_RECALL>;
+    using audio_in_recall = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_IN_RECALL>;
+    using audio_out_recall = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_OUT_RECALL>;
+    using lost_lock_reset = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::LOST_LOCK_RESET>;
+    using auto_mode_off = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUTO_MODE_OFF>;
+    using auto_mode_on = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUTO_MODE_ON>;
+    using spot_erase_off = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::SPOT_ERASE_OFF>;
+    using spot_erase_on = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::SPOT_ERASE_ON>;
+    using audio_split_off = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_SPLIT_OFF>;
+    using audio_split_on = PrebuiltPacket<Cmd1::PRESET_SELECT_CONTROL, PresetSelectCtrl::AUDIO_SPLIT_ON>;
+    // 6 - Sense Request
+    using tc_gen_sense_tc = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::TC_GEN_SENSE, TcGenData::TC>;
+    using tc_gen_sense_ub = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::TC_GEN_SENSE, TcGenData::UB>;
+    using tc_ub_gen_sense_tc_and_ub = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::TC_GEN_SENSE, TcGenData::TC_UB>;
+    using current_time_sense_timer1 = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::TIMER_1>;
+    using current_time_sense_timer2 = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::TIMER_2>;
+    using current_time_sense_ltc_tc_ub = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::LTC_UB | CurrentTimeSenseFlag::LTC_TC>;
+    using current_time_sense_ltc_tc = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::LTC_TC>;
+    using current_time_sense_ltc_ub = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::LTC_UB>;
+    using current_time_sense_vitc_tc_ub = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::VITC_UB | CurrentTimeSenseFlag::VITC_TC>;
+    using current_time_sense_vitc_tc = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::VITC_TC>;
+    using current_time_sense_vitc_ub = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CURRENT_TIME_SENSE, CurrentTimeSenseFlag::VITC_UB>;
+    using in_data_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::IN_DATA_SENSE>;
+    using out_data_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::OUT_DATA_SENSE>;
+    using audio_in_data_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::AUDIO_IN_DATA_SENSE>;
+    using audio_out_data_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::AUDIO_OUT_DATA_SENSE>;
+    using status_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::STATUS_SENSE, 0x0A>;  // start = 0, size = 10
+    using remaining_time_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::REMAINING_TIME_SENSE>;
+    using cmd_speed_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::CMD_SPEED_SENSE>;
+    using preroll_time_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::PREROLL_TIME_SENSE>;
+    using timer_mode_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::TIMER_MODE_SENSE>;
+    using record_inhibit_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::RECORD_INHIBIT_SENSE>;
+    using da_inp_emph_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::DA_INPUT_EMPHASIS_SENSE>;
+    using da_pb_emph_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::DA_PLAYBACK_EMPHASIS_SENSE>;
+    using da_samp_freq_sense = PrebuiltPacket<Cmd1::SENSE_REQUEST, SenseRequest::DA_SAMPLING_FREQUENCY_SENSE>;
+    // A - BlackMagic Advanced Media Protocol
+    using clear_playlist = PrebuiltPacket<Cmd1::TRANSPORT_CONTROL, TransportCtrl::CLEAR_PLAYLIST>;
+}  // namespace prebuilt
+
 }  // namespace sony9pin
 
 #include <DebugLogRestoreState.h>
@@ -0,0 +1,367 @@
+#pragma once
+#ifndef SONY9PINREMOTE_GROUP_ROLL_H
+#define SONY9PINREMOTE_GROUP_ROLL_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../Sony9PinRemote.h"
+
+#ifdef SONY9PINREMOTE_DEBUGLOG_ENABLE
+#include <DebugLogEnable.h>
+#else
+#include <DebugLogDisable.h>
+#endif
+
+namespace sony9pin {
+
+// Starts several decks together (e.g. play / record / sync play for multicam ISO recording).
+// The packets are encoded and queued on every deck in advance while the decks are held,
+// then released back to back as soon as all decks can send, so the decks receive them
+// within the same frame. After that the status of each deck is polled until the transport
+// has actually started, and the start time of each deck is reported as the skew from the earliest one.
+// The status poll only tells that a deck has started within the last round trip, so if the decks
+// were cued up, set the cue point: the current time of each started deck is then sensed,
+// and its start time is the time of that reply minus the frames it has moved from the cue point.
+// If a deck fails after the packets are released, STOP is written at once (ahead of the queued polls)
+// to every deck which got the packet, and the packets which are still queued are cancelled.
+//
+//     GroupRoll<4> roll;
+//     roll.add(deck_a);
+//     roll.add(deck_b);
+//     roll.set_cue_point(TimeCode::hmsf(1, 0, 0, 0));  // optional, where the decks were cued up
+//     roll.arm<prebuilt::record>();
+//     while (roll.busy()) roll.update();
+//     if (roll.state() == GroupRoll<4>::State::DONE) roll.member(1).skew_frames;
+//
+// The decks must not be in `force_send` mode, because the ACKs are needed to confirm the start.
+// `update()` parses the replies of all member decks, so do not parse them elsewhere while rolling.
+template <typename Clock, size_t N>
+class BasicGroupRoll {
+    static_assert(N > 0, "BasicGroupRoll size must be greater than 0");
+
+public:
+    using ControllerType = BasicController<Clock>;
+
+    enum class State : uint8_t {
+        IDLE,     // not armed
+        ARMED,    // waiting for all decks to be able to send
+        ROLLING,  // released, waiting for the decks to start
+        DONE,     // every deck has started
+        FAILED,   // NAK, reply timeout, or the decks did not start in time
+    };
+
+    struct Member {
+        ControllerType* deck {nullptr};
+        uint8_t packet[MAX_PACKET_SIZE];
+        uint8_t size {0};
+        CommandId roll_id {0};
+        CommandId status_id {0};
+        CommandId tc_id {0};
+        uint32_t sent_us {0};     // when the packet was written
+        uint32_t started_us {0};  // when the transport has started (estimated from the timecode if the cue point is set)
+        TimeCode tc;              // current time sensed after the start (if the cue point is set)
+        uint32_t tc_us {0};       // when `tc` was latched (middle of the round trip)
+        bool acked {false};
+        bool started {false};
+        bool measured {false};  // `tc` is sensed
+        bool failed {false};
+        int32_t skew_us {0};  // started_us - the earliest started_us of the group
+        int32_t skew_frames {0};
+    };
+
+private:
+    Member members[N];
+    size_t count {0};
+    State st {State::IDLE};
+    FrameRate rate {FrameRate::NONE};
+    uint32_t timeout_us {1000000};
+    uint32_t armed_us {0};
+    TimeCode cue;
+    uint8_t cue_sense {0};  // CurrentTimeSenseFlag to sense the timecode, 0 if the cue point is not set
+    bool no_tc {false};     // a deck did not return the current time, so the status poll is used
+
+public:
+    bool add(ControllerType& deck) {
+        if (count == N || busy()) return false;
+        members[count] = Member();
+        members[count].deck = &deck;
+        ++count;
+        return true;
+    }
+
+    void clear() {
+        abort();
+        count = 0;
+        st = State::IDLE;
+    }
+
+    size_t size() const { return count; }
+    const Member& member(const size_t i) const { return members[i]; }
+    State state() const { return st; }
+    bool busy() const { return st == State::ARMED || st == State::ROLLING; }
+
+    // frame rate to convert the skew into frames (the rate of the first deck is used if not set)
+    void set_frame_rate(const FrameRate fps) { rate = fps; }
+    // max time from arm() to the start of all decks
+    void set_timeout(const uint32_t ms) { timeout_us = ms * 1000; }
+    // Timecode where the decks were cued up, to measure the skew from the timecode of each deck
+    // (sensed by CURRENT TIME SENSE with `sense`, e.g. CurrentTimeSenseFlag::TIMER_1).
+    // The frame rate is needed (set_frame_rate() or the one of the first deck).
+    void set_cue_point(const TimeCode& tc, const uint8_t sense = CurrentTimeSenseFlag::LTC_TC) {
+        cue = tc;
+        cue_sense = sense;
+    }
+    void clear_cue_point() { cue_sense = 0; }
+
+    // =============== Arm ===============
+
+    // same packet for every deck, e.g. `arm<prebuilt::play>()`
+    template <typename P>
+    bool arm() {
+        return arm(P::data, P::size);
+    }
+
+    bool arm(const uint8_t* data, const size_t size) {
+        for (size_t i = 0; i < count; ++i)
+            if (!prepare(i, data, size)) return false;
+        return start();
+    }
+
+    // Different packet for each deck: prepare() every member, then arm().
+    bool prepare(const size_t i, const uint8_t* data, const size_t size) {
+        if (i >= count || size == 0 || size > MAX_PACKET_SIZE || busy()) return false;
+        memcpy(members[i].packet, data, size);
+        members[i].size = (uint8_t)size;
+        return true;
+    }
+
+    bool arm() {
+        for (size_t i = 0; i < count; ++i)
+            if (members[i].size == 0) return false;
+        return start();
+    }
+
+    // Release the decks held by arm() and stop rolling.
+    // The packets which have not been written yet are cancelled, so those decks never start,
+    // and STOP is written at once to the decks which got the packet, without waiting for
+    // the commands in flight or queued before it (e.g. the status polls) to time out.
+    void abort() {
+        if (!busy()) return;
+        for (size_t i = 0; i < count; ++i) {
+            Member& m = members[i];
+            const CommandRecord* r = m.roll_id ? m.deck->command(m.roll_id) : nullptr;
+            if (r && r->status == CommandStatus::QUEUED) {
+                m.deck->cancel(m.roll_id);
+                m.roll_id = 0;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) members[i].deck->hold(false);
+        for (size_t i = 0; i < count; ++i)
+            if (members[i].roll_id && needs_status(members[i])) members[i].deck->stop_now();
+        st = State::FAILED;
+    }
+
+    // =============== Update ===============
+
+    // Call repeatedly until DONE or FAILED.
+    State update() {
+        if (!busy()) return st;
+        for (size_t i = 0; i < count; ++i)
+            while (members[i].deck->parse()) {
+            }
+
+        const uint32_t now = Clock::micros();
+        if ((uint32_t)(now - armed_us) > timeout_us) {
+            LOG_WARN("group roll timeout");
+            abort();
+            return st;
+        }
+        if (st == State::ARMED)
+            release();
+        else
+            confirm();
+        return st;
+    }
+
+    // time from the first write to the last one
+    uint32_t release_spread_us() const {
+        if (count == 0 || st == State::IDLE || st == State::ARMED) return 0;
+        uint32_t spread = 0;
+        for (size_t i = 1; i < count; ++i) {
+            const uint32_t d = members[i].sent_us - members[0].sent_us;
+            if (d > spread) spread = d;
+        }
+        return spread;
+    }
+
+    int32_t max_skew_frames() const {
+        int32_t m = 0;
+        for (size_t i = 0; i < count; ++i)
+            if (members[i].skew_frames > m) m = members[i].skew_frames;
+        return m;
+    }
+
+private:
+    bool start() {
+        if (count == 0 || busy()) return false;
+        for (size_t i = 0; i < count; ++i) {
+            Member& m = members[i];
+            m.roll_id = m.status_id = m.tc_id = 0;
+            m.sent_us = m.started_us = m.tc_us = 0;
+            m.tc = TimeCode();
+            m.acked = m.started = m.measured = m.failed = false;
+            m.skew_us = m.skew_frames = 0;
+        }
+        no_tc = false;
+        armed_us = Clock::micros();
+        st = State::ARMED;
+        return true;
+    }
+
+    // stage the packets on the held decks, then release them back to back
+    void release() {
+        for (size_t i = 0; i < count; ++i)
+            if (!members[i].deck->idle()) return;
+
+        for (size_t i = 0; i < count; ++i) {
+            members[i].deck->hold(true);
+            members[i].roll_id = members[i].deck->send(members[i].packet, members[i].size);
+        }
+        for (size_t i = 0; i < count; ++i)
+            members[i].deck->hold(false);
+
+        for (size_t i = 0; i < count; ++i) {
+            const CommandRecord* r = members[i].deck->command(members[i].roll_id);
+            if (!r || r->status == CommandStatus::QUEUED) {
+                LOG_ERROR("group roll: deck", i, "could not send");
+                abort();
+                return;
+            }
+            members[i].sent_us = r->sent_us;
+        }
+        st = State::ROLLING;
+    }
+
+    void confirm() {
+        const FrameRate fps = (rate != FrameRate::NONE) ? rate : members[0].deck->get_frame_rate();
+        const uint32_t interval = frame_interval_us(fps);
+        bool all_started = true;
+        for (size_t i = 0; i < count; ++i) {
+            Member& m = members[i];
+            if (!m.started) check(i);
+            if (cue_sense && interval && !no_tc && m.started && !m.measured && needs_status(m)) measure(i);
+            if (m.failed) {
+                abort();
+                return;
+            }
+            all_started &= m.started;
+        }
+        const bool by_tc = cue_sense && interval && !no_tc;
+        if (by_tc)
+            for (size_t i = 0; i < count; ++i)
+                all_started &= members[i].measured || !needs_status(members[i]);
+        if (!all_started) return;
+
+        // the deck has moved (tc - cue) frames since it started
+        if (by_tc)
+            for (size_t i = 0; i < count; ++i) {
+                Member& m = members[i];
+                if (m.measured)
+                    m.started_us = m.tc_us - (uint32_t)(timecode::diff(m.tc, cue, fps) * (int32_t)interval);
+            }
+
+        uint32_t earliest = members[0].started_us;
+        for (size_t i = 1; i < count; ++i)
+            if ((int32_t)(members[i].started_us - earliest) < 0) earliest = members[i].started_us;
+        for (size_t i = 0; i < count; ++i) {
+            Member& m = members[i];
+            m.skew_us = (int32_t)(m.started_us - earliest);
+            m.skew_frames = interval ? (int32_t)(((uint32_t)m.skew_us + interval / 2) / interval) : 0;
+        }
+        st = State::DONE;
+    }
+
+    // ACK of the roll command, then the status polled until the transport has started
+    void check(const size_t i) {
+        Member& m = members[i];
+        ControllerType& deck = *m.deck;
+        if (!m.acked) {
+            const CommandRecord* r = deck.command(m.roll_id);
+            if (!r || r->pending()) return;
+            if (r->status != CommandStatus::ACK) {
+                LOG_WARN("group roll: deck", i, "did not ACK");
+                m.failed = true;
+                return;
+            }
+            m.acked = true;
+            if (!needs_status(m)) {
+                m.started = true;
+                m.started_us = r->replied_us;
+                return;
+            }
+        }
+        if (m.status_id) {
+            const CommandRecord* r = deck.command(m.status_id);
+            if (r && r->pending()) return;
+            if (r && r->status == CommandStatus::REPLY && has_started(m, deck.raw_status())) {
+                m.started = true;
+                m.started_us = r->sent_us + (r->replied_us - r->sent_us) / 2;
+                return;
+            }
+        }
+        m.status_id = deck.status_sense(1, 1);  // byte 1 has PLAY / RECORD
+    }
+
+    // current time of the started deck
+    void measure(const size_t i) {
+        Member& m = members[i];
+        ControllerType& deck = *m.deck;
+        if (m.tc_id) {
+            const CommandRecord* r = deck.command(m.tc_id);
+            if (r && r->pending()) return;
+            if (r && r->status == CommandStatus::REPLY) {
+                // decoded by the sense cache, unless another reply of the same source has replaced it
+                const Cached<TimeCode> tc = deck.sense_cache().timecode(r->reply_cmd2);
+                if (tc.valid && tc.timestamp_us == r->replied_us) {
+                    m.tc = tc.value;
+                    m.tc_us = r->sent_us + (r->replied_us - r->sent_us) / 2;
+                    m.measured = true;
+                    return;
+                }
+            } else if (r) {
+                LOG_WARN("group roll: deck", i, "did not return the current time, skew from the status poll");
+                no_tc = true;
+                return;
+            }
+        }
+        m.tc_id = deck.current_time_sense(cue_sense);
+    }
+
+    static bool needs_status(const Member& m) {
+        if ((m.packet[0] & (uint8_t)HeaderMask::CMD1) != (uint8_t)Cmd1::TRANSPORT_CONTROL) return false;
+        switch (m.packet[1]) {
+            case TransportCtrl::PLAY:
+            case TransportCtrl::SYNC_PLAY:
+            case TransportCtrl::RECORD: return true;
+            default: return false;
+        }
+    }
+
+    static bool has_started(const Member& m, const RawStatus& sts) {
+        return (m.packet[1] == TransportCtrl::RECORD) ? sts.record() : sts.play();
+    }
+};
+
+template <size_t N>
+using GroupRoll = BasicGroupRoll<DefaultClock, N>;
+
+}  // namespace sony9pin
+
+#include <DebugLogRestoreState.h>
+
+#endif  // SONY9PINREMOTE_GROUP_ROLL_H
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef SONY9PINREMOTE_HANDLERS_H
+#define SONY9PINREMOTE_HANDLERS_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+
+#include "Types.h"
+#include "Decoder.h"
+
+namespace sony9pin {
+
+// Callbacks for the replies completed by `Controller::parse(handlers)`.
+// Derive from this and hide only the ones you need; the calls are resolved at compile time
+// against the type passed to `parse()` (no virtual call, no std::function), and the empty
+// ones are inlined away.
+//
+//     struct DeckEvents : Sony9PinRemote::NullHandlers {
+//         void on_nak(const Sony9PinRemote::Errors& e) { ... }
+//         void on_timecode(const uint8_t source, const Sony9PinRemote::TimeCode& tc) { ... }
+//     };
+//     DeckEvents events;
+//     while (deck.parse(events));
+//
+// They are called after the Controller has updated its own state (status, errors, sense cache...)
+// and dispatched the next queued command, so commands can be sent from the handlers.
+struct NullHandlers {
+    // every reply, before the typed handler below (`decoder` holds the packet)
+    void on_packet(const Decoder&) {}
+    // 10.01 ACK
+    void on_ack() {}
+    // 11.12.XX NAK
+    void on_nak(const Errors&) {}
+    // 12.11 DEVICE TYPE
+    void on_device_type(const uint16_t) {}
+    // 7X.20 STATUS DATA; the status after the requested range is applied
+    void on_status(const Status&) {}
+    // any sense return starting with a timecode: current time (TIMER-1/2, LTC, VITC, GEN and their
+    // interpolated / hold variants), IN / OUT data and preroll time.
+    // `source` is its Cmd2 (e.g. SenseReturn::LTC_TC)
+    void on_timecode(const uint8_t, const TimeCode&) {}
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_HANDLERS_H
@@ -0,0 +1,194 @@
+#pragma once
+#ifndef SONY9PINREMOTE_LATENCY_HISTOGRAM_H
+#define SONY9PINREMOTE_LATENCY_HISTOGRAM_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Types.h"
+
+namespace sony9pin {
+
+// summary of the round trips of one command (from write to the completed reply) [us]
+struct LatencySnapshot {
+    Cmd1 cmd1 {Cmd1::NA};
+    uint8_t cmd2 {0xFF};
+    uint32_t count {0};     // number of replies
+    uint32_t timeouts {0};  // number of commands without reply
+    uint32_t min_us {0};
+    uint32_t p50_us {0};
+    uint32_t p99_us {0};
+    uint32_t max_us {0};
+};
+
+// Log-bucketed histogram of round-trip times with fixed memory.
+// Each power of two is split into 4 buckets, so the percentiles are within 25% of the actual value.
+// Values from 0 to 2^24 us (~16.7 sec) are counted; longer ones go to the last bucket.
+class LatencyHistogram {
+    enum : uint8_t {
+        SUB_BITS = 2,
+        MAX_BITS = 24,
+        NUM_BUCKETS = (MAX_BITS - SUB_BITS + 1) << SUB_BITS,
+    };
+
+    Cmd1 key_cmd1 {Cmd1::NA};
+    uint8_t key_cmd2 {0xFF};
+    uint32_t n {0};
+    uint32_t n_timeout {0};
+    uint32_t min_us {0xFFFFFFFF};
+    uint32_t max_us {0};
+    uint16_t buckets[NUM_BUCKETS];
+
+public:
+    LatencyHistogram() { reset(Cmd1::NA, 0xFF); }
+
+    void reset(const Cmd1 cmd1, const uint8_t cmd2) {
+        key_cmd1 = cmd1;
+        key_cmd2 = cmd2;
+        n = n_timeout = max_us = 0;
+        min_us = 0xFFFFFFFF;
+        for (auto& b : buckets) b = 0;
+    }
+
+    bool is(const Cmd1 cmd1, const uint8_t cmd2) const { return key_cmd1 == cmd1 && key_cmd2 == cmd2; }
+
+    void add(const uint32_t us) {
+        ++n;
+        if (us < min_us) min_us = us;
+        if (us > max_us) max_us = us;
+        uint16_t& b = buckets[bucket(us)];
+        if (b == 0xFFFF) {
+            // halve all buckets so that the shape of the distribution is kept
+            for (auto& c : buckets) c = (c + 1) >> 1;
+        }
+        ++b;
+    }
+
+    void add_timeout() { ++n_timeout; }
+
+    // upper bound of the bucket containing the `pct` percentile, clamped by min and max
+    uint32_t percentile(const uint8_t pct) const {
+        uint32_t total = 0;
+        for (const auto& b : buckets) total += b;
+        if (total == 0) return 0;
+        uint32_t target = (total * pct + 99) / 100;
+        if (target == 0) target = 1;
+        uint32_t sum = 0;
+        for (uint8_t i = 0; i < NUM_BUCKETS; ++i) {
+            sum += buckets[i];
+            if (sum >= target) {
+                const uint32_t v = upper_bound(i);
+                return (v < min_us) ? min_us : (v > max_us) ? max_us : v;
+            }
+        }
+        return max_us;
+    }
+
+    LatencySnapshot snapshot() const {
+        LatencySnapshot s;
+        s.cmd1 = key_cmd1;
+        s.cmd2 = key_cmd2;
+        s.count = n;
+        s.timeouts = n_timeout;
+        s.min_us = n ? min_us : 0;
+        s.p50_us = percentile(50);
+        s.p99_us = percentile(99);
+        s.max_us = max_us;
+        return s;
+    }
+
+private:
+    // 0-3 are counted as is, then 4 buckets per power of two
+    static uint8_t bucket(const uint32_t us) {
+        if (us >= ((uint32_t)1 << MAX_BITS)) return NUM_BUCKETS - 1;
+        if (us < ((uint32_t)1 << SUB_BITS)) return (uint8_t)us;
+        uint8_t msb = SUB_BITS;
+        while (us >> (msb + 1)) ++msb;
+        const uint8_t sub = (uint8_t)(us >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+        return (uint8_t)(((msb - SUB_BITS + 1) << SUB_BITS) + sub);
+    }
+
+    static uint32_t lower_bound(const uint8_t i) {
+        if (i < (1 << SUB_BITS)) return i;
+        const uint8_t msb = (i >> SUB_BITS) + SUB_BITS - 1;
+        const uint32_t sub = i & ((1 << SUB_BITS) - 1);
+        return (((uint32_t)1 << SUB_BITS) + sub) << (msb - SUB_BITS);
+    }
+
+    static uint32_t upper_bound(const uint8_t i) {
+        return (i + 1 < NUM_BUCKETS) ? lower_bound(i + 1) - 1 : 0xFFFFFFFF;
+    }
+};
+
+// Histograms keyed by (Cmd1, Cmd2) of the commands.
+// A slot is assigned to each command at its first reply; commands beyond N slots are not recorded.
+// N = 0 disables the recording without any memory (see the specialization below).
+template <size_t N>
+class LatencyHistograms {
+
+    LatencyHistogram histograms[N];
+    size_t used {0};
+    size_t n_untracked {0};
+
+public:
+    void add(const Cmd1 cmd1, const uint8_t cmd2, const uint32_t us) {
+        if (LatencyHistogram* h = find_or_assign(cmd1, cmd2)) h->add(us);
+    }
+
+    void add_timeout(const Cmd1 cmd1, const uint8_t cmd2) {
+        if (LatencyHistogram* h = find_or_assign(cmd1, cmd2)) h->add_timeout();
+    }
+
+    // returns false if the command has not been recorded
+    bool snapshot(const Cmd1 cmd1, const uint8_t cmd2, LatencySnapshot& s) const {
+        for (size_t i = 0; i < used; ++i) {
+            if (histograms[i].is(cmd1, cmd2)) {
+                s = histograms[i].snapshot();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // in the order of the first reply
+    LatencySnapshot snapshot(const size_t i) const { return (i < used) ? histograms[i].snapshot() : LatencySnapshot(); }
+    size_t size() const { return used; }
+    size_t untracked() const { return n_untracked; }  // replies not recorded because all slots were used
+
+    void clear() {
+        for (size_t i = 0; i < used; ++i) histograms[i].reset(Cmd1::NA, 0xFF);
+        used = n_untracked = 0;
+    }
+
+private:
+    LatencyHistogram* find_or_assign(const Cmd1 cmd1, const uint8_t cmd2) {
+        for (size_t i = 0; i < used; ++i)
+            if (histograms[i].is(cmd1, cmd2)) return &histograms[i];
+        if (used == N) {
+            ++n_untracked;
+            return nullptr;
+        }
+        histograms[used].reset(cmd1, cmd2);
+        return &histograms[used++];
+    }
+};
+
+// nothing is recorded (each histogram takes ~200 bytes, too much for small MCUs)
+template <>
+class LatencyHistograms<0> {
+public:
+    void add(const Cmd1, const uint8_t, const uint32_t) {}
+    void add_timeout(const Cmd1, const uint8_t) {}
+    bool snapshot(const Cmd1, const uint8_t, LatencySnapshot&) const { return false; }
+    LatencySnapshot snapshot(const size_t) const { return LatencySnapshot(); }
+    size_t size() const { return 0; }
+    size_t untracked() const { return 0; }
+    void clear() {}
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_LATENCY_HISTOGRAM_H
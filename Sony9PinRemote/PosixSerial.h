@@ -0,0 +1,161 @@
+#pragma once
+#ifndef SONY9PINREMOTE_POSIX_SERIAL_H
+#define SONY9PINREMOTE_POSIX_SERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+namespace sony9pin {
+
+// Thin termios wrapper used as `StreamType` on Linux / macOS hosts.
+// The port is opened as 38400 8O1 (Sony 9-Pin default) in raw, non-canonical mode
+// and every method maps to a single syscall (write() polls too while the output is full)
+// so that nothing sits between `Controller` and the kernel tty driver.
+// Bytes received with a parity error are dropped, so the packet containing them fails its checksum.
+class PosixSerial {
+    int fd {-1};
+    bool b_owned {false};
+    mutable size_t n_syscalls {0};
+
+public:
+    PosixSerial() {}
+    ~PosixSerial() { close(); }
+
+    PosixSerial(const PosixSerial&) = delete;
+    PosixSerial& operator=(const PosixSerial&) = delete;
+
+    // vmin / vtime are passed to VMIN / VTIME as is (vtime is in 1/10 sec).
+    // Default is fully non-blocking: read() returns whatever is in the driver buffer.
+    bool open(const char* path, const speed_t baud = B38400, const uint8_t vmin = 0, const uint8_t vtime = 0) {
+        close();
+        const int new_fd = ::open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (new_fd < 0) return false;
+        fd = new_fd;
+        b_owned = true;
+        if (!configure(baud, vmin, vtime)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Use the file descriptor which is already opened (e.g. the slave side of a pty).
+    // It is not closed by this class. If `configure_port` is true, it is configured in the same way as open().
+    bool attach(const int handle, const bool configure_port = true, const speed_t baud = B38400, const uint8_t vmin = 0, const uint8_t vtime = 0) {
+        close();
+        if (handle < 0) return false;
+        fd = handle;
+        b_owned = false;
+        if (configure_port && !configure(baud, vmin, vtime)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0 && b_owned) ::close(fd);
+        fd = -1;
+        b_owned = false;
+    }
+
+    bool is_open() const { return fd >= 0; }
+    int handle() const { return fd; }
+
+    // If the output buffer is full (EAGAIN on a non-blocking fd), sleep in poll() until it drains
+    // instead of spinning. Returns the bytes written, which are less than `size` only on error.
+    size_t write(const uint8_t* data, const size_t size) {
+        size_t sent = 0;
+        while (sent < size) {
+            ++n_syscalls;
+            const ssize_t n = ::write(fd, data + sent, size - sent);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_writable()) continue;
+                break;
+            }
+            sent += (size_t)n;
+        }
+        return sent;
+    }
+
+    size_t read(uint8_t* data, const size_t size) {
+        ssize_t n = 0;
+        do {
+            ++n_syscalls;
+            n = ::read(fd, data, size);
+        } while (n < 0 && errno == EINTR);
+        return n < 0 ? 0 : (size_t)n;
+    }
+
+    size_t available() const {
+        int n = 0;
+        if (fd < 0) return 0;
+        ++n_syscalls;
+        if (::ioctl(fd, FIONREAD, &n) != 0) return 0;
+        return n < 0 ? 0 : (size_t)n;
+    }
+
+    // Block until a byte can be read or the timeout expires (rounded up to milliseconds).
+    // Returns true if readable.
+    bool wait(const uint32_t timeout_us) const {
+        if (fd < 0) return false;
+        const uint32_t ms = timeout_us / 1000 + ((timeout_us % 1000) ? 1 : 0);
+        pollfd pfd {fd, POLLIN, 0};
+        int r = 0;
+        do {
+            ++n_syscalls;
+            r = ::poll(&pfd, 1, (ms > 0x7FFFFFFF) ? 0x7FFFFFFF : (int)ms);
+        } while (r < 0 && errno == EINTR);
+        return r > 0;
+    }
+
+    // wait until all output has been transmitted (same as Arduino's Stream::flush())
+    void flush() {
+        if (fd < 0) return;
+        ++n_syscalls;
+        ::tcdrain(fd);
+    }
+
+    // number of syscalls made by the methods above (e.g. to measure the I/O cost per command)
+    size_t syscall_count() const { return n_syscalls; }
+    void reset_syscall_count() { n_syscalls = 0; }
+
+private:
+    bool wait_writable() const {
+        pollfd pfd {fd, POLLOUT, 0};
+        int r = 0;
+        do {
+            ++n_syscalls;
+            r = ::poll(&pfd, 1, -1);
+        } while (r < 0 && errno == EINTR);
+        return r > 0 && !(pfd.revents & (POLLERR | POLLHUP | POLLNVAL));
+    }
+
+    bool configure(const speed_t baud, const uint8_t vmin, const uint8_t vtime) {
+        termios tio;
+        if (::tcgetattr(fd, &tio) != 0) return false;
+        ::cfmakeraw(&tio);
+        tio.c_cflag &= ~(CSIZE | CSTOPB | CRTSCTS);
+        tio.c_cflag |= CS8 | PARENB | PARODD | CLOCAL | CREAD;  // 8O1
+        tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+        tio.c_iflag |= INPCK | IGNPAR;  // check the parity on receive and drop the broken bytes
+        tio.c_cc[VMIN] = vmin;
+        tio.c_cc[VTIME] = vtime;
+        ::cfsetispeed(&tio, baud);
+        ::cfsetospeed(&tio, baud);
+        if (::tcsetattr(fd, TCSANOW, &tio) != 0) return false;
+        ::tcflush(fd, TCIOFLUSH);
+        return true;
+    }
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_POSIX_SERIAL_H
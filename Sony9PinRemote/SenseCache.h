@@ -0,0 +1,271 @@
+#pragma once
+#ifndef SONY9PINREMOTE_SENSE_CACHE_H
+#define SONY9PINREMOTE_SENSE_CACHE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Types.h"
+#include "Commands.h"
+#include <ArxTypeTraits.h>
+
+#if ARX_HAVE_LIBSTDCPLUSPLUS >= 201103L  // Have libstdc++11
+#include <atomic>
+#define SONY9PINREMOTE_SENSE_CACHE_SEQLOCK
+#endif
+
+namespace sony9pin {
+
+// value decoded from a cached reply and when it was received
+template <typename T>
+struct Cached {
+    T value {};
+    uint32_t timestamp_us {0};  // Controller clock when the reply was parsed
+    bool valid {false};         // false if the reply has not been received yet
+
+    uint32_t age_us(const uint32_t now_us) const { return now_us - timestamp_us; }
+    // valid and received within `max_age_us` before `now_us`
+    bool fresh(const uint32_t now_us, const uint32_t max_age_us) const { return valid && age_us(now_us) <= max_age_us; }
+};
+
+// Latest data of each sense return (keyed by cmd2) with its receive time,
+// so that the values can be read at any time after the Decoder has moved on to the next packet.
+// The raw data bytes are kept and decoded on read; a slot is assigned to each cmd2 at its first reply,
+// and the least recently updated one is reused when all N slots are used.
+// STATUS DATA is not cached here because Controller keeps it as `raw_status()`.
+//
+//     auto tc = deck.sense_cache().ltc_tc();
+//     if (tc.fresh(micros(), 500000)) show(tc.value);
+//
+// The values can be read from another thread (e.g. UI or automation) while `parse()` stores the replies:
+// the cache is guarded by a sequence counter (seqlock), and a reader copies the entry again
+// if a reply was stored while it was copying, so it never sees a half-written timecode.
+// Each accessor is consistent on its own; copy the whole cache (`auto c = deck.sense_cache();`)
+// to read several values of the same moment. Only one thread may write (`store()` / `clear()`).
+// Without libstdc++11 (e.g. AVR) there is no atomic counter and it is not synchronized.
+template <size_t N>
+class SenseCache {
+    static_assert(N > 0, "SenseCache size must be greater than 0");
+
+public:
+    static constexpr uint8_t MAX_DATA_SIZE {TIMECODE_USERBITS_SIZE};
+
+private:
+    struct Entry {
+        uint32_t timestamp_us;
+        uint8_t cmd2;
+        uint8_t size;
+        uint8_t data[MAX_DATA_SIZE];
+    };
+
+    Entry entries[N];
+    size_t used {0};
+    size_t n_evicted {0};
+#ifdef SONY9PINREMOTE_SENSE_CACHE_SEQLOCK
+    std::atomic<uint32_t> seq {0};  // odd while being written
+#endif
+
+public:
+    SenseCache() = default;
+    // consistent snapshot of `other` (can be taken from another thread)
+    SenseCache(const SenseCache& other) { other.copy_to(*this); }
+    SenseCache& operator=(const SenseCache& other) {
+        if (this != &other) {
+            SenseCache tmp(other);
+            begin_write();
+            memcpy(entries, tmp.entries, sizeof(entries));
+            used = tmp.used;
+            n_evicted = tmp.n_evicted;
+            end_write();
+        }
+        return *this;
+    }
+
+    // store the data of a sense return (replies longer than MAX_DATA_SIZE are ignored)
+    void store(const uint8_t cmd2, const uint8_t* data, const uint8_t size, const uint32_t now_us) {
+        if (size > MAX_DATA_SIZE || (size > 0 && !data)) return;
+        begin_write();
+        Entry* e = find(cmd2);
+        if (!e) e = assign(now_us);
+        e->timestamp_us = now_us;
+        e->cmd2 = cmd2;
+        e->size = size;
+        if (size > 0) memcpy(e->data, data, size);
+        end_write();
+    }
+
+    void clear() {
+        begin_write();
+        used = n_evicted = 0;
+        end_write();
+    }
+    size_t size() const { return used; }
+    size_t evicted() const { return n_evicted; }  // slots reused for other sense returns
+
+    // =============== Generic ===============
+
+    // any sense return whose data starts with a timecode (e.g. SenseReturn::IN_DATA)
+    Cached<TimeCode> timecode(const uint8_t cmd2) const {
+        Cached<TimeCode> c;
+        Entry e;
+        if (!snapshot(cmd2, e) || e.size < TIMECODE_SIZE || !reply_info((uint8_t)Cmd1::SENSE_RETURN, cmd2).timecode()) return c;
+        c.value = TimeCode::decode_bcd(e.data);
+        c.timestamp_us = e.timestamp_us;
+        c.valid = true;
+        return c;
+    }
+
+    // timecode and userbits in one reply (78.XX)
+    Cached<TimeCodeAndUserBits> timecode_userbits(const uint8_t cmd2) const {
+        Cached<TimeCodeAndUserBits> c;
+        Entry e;
+        if (!snapshot(cmd2, e) || e.size != TIMECODE_USERBITS_SIZE) return c;
+        c.value.tc = TimeCode::decode_bcd(e.data);
+        memcpy(c.value.ub.bytes, e.data + TIMECODE_SIZE, sizeof(UserBits));
+        c.timestamp_us = e.timestamp_us;
+        c.valid = true;
+        return c;
+    }
+
+    // userbits only reply (e.g. SenseReturn::LTC_UB)
+    Cached<UserBits> userbits(const uint8_t cmd2) const {
+        Cached<UserBits> c;
+        Entry e;
+        if (!snapshot(cmd2, e) || e.size != sizeof(UserBits)) return c;
+        memcpy(c.value.bytes, e.data, sizeof(UserBits));
+        c.timestamp_us = e.timestamp_us;
+        c.valid = true;
+        return c;
+    }
+
+    // =============== Current Time / TC Generator ===============
+
+    Cached<TimeCode> timer1_tc() const { return timecode(SenseReturn::TIMER_1); }
+    Cached<TimeCode> timer2_tc() const { return timecode(SenseReturn::TIMER_2); }
+    Cached<TimeCode> ltc_tc() const { return timecode(SenseReturn::LTC_TC); }
+    Cached<TimeCode> vitc_tc() const { return timecode(SenseReturn::VITC_TC); }
+    Cached<TimeCode> gen_tc() const { return timecode(SenseReturn::GEN_TC); }
+    Cached<TimeCode> ltc_interpolated_tc() const { return timecode(SenseReturn::LTC_INTERPOLATED_TC); }
+    Cached<TimeCode> hold_vitc_tc() const { return timecode(SenseReturn::HOLD_VITC_TC); }
+
+    // the newer one of the userbits only reply and the userbits in the timecode + userbits reply
+    Cached<UserBits> ltc_ub() const { return newer_userbits(SenseReturn::LTC_TC_UB, SenseReturn::LTC_UB); }
+    Cached<UserBits> vitc_ub() const { return newer_userbits(SenseReturn::VITC_TC_UB, SenseReturn::VITC_UB); }
+    Cached<UserBits> gen_ub() const { return newer_userbits(SenseReturn::GEN_TC_UB, SenseReturn::GEN_UB); }
+    Cached<UserBits> ltc_interpolated_ub() const { return newer_userbits(SenseReturn::LTC_INTERPOLATED_TC_UB, SenseReturn::LTC_INTERPOLATED_UB); }
+    Cached<UserBits> hold_vitc_ub() const { return newer_userbits(SenseReturn::HOLD_VITC_TC_UB, SenseReturn::HOLD_VITC_UB); }
+
+    // =============== Other Sense Returns ===============
+
+    Cached<TimeCode> in_data() const { return timecode(SenseReturn::IN_DATA); }
+    Cached<TimeCode> out_data() const { return timecode(SenseReturn::OUT_DATA); }
+    Cached<TimeCode> audio_in_data() const { return timecode(SenseReturn::AUDIO_IN_DATA); }
+    Cached<TimeCode> audio_out_data() const { return timecode(SenseReturn::AUDIO_OUT_DATA); }
+    Cached<TimeCode> preroll_time() const { return timecode(SenseReturn::PREROLL_TIME); }
+
+    Cached<TimerMode> timer_mode() const {
+        Cached<TimerMode> c;
+        Entry e;
+        if (!snapshot(SenseReturn::TIMER_MODE_STATUS, e) || !reply_info((uint8_t)Cmd1::SENSE_RETURN, SenseReturn::TIMER_MODE_STATUS).accepts(e.size)) return c;
+        switch (e.data[0]) {
+            case 0x00: c.value = TimerMode::TIME_CODE; break;
+            case 0x01: c.value = TimerMode::CTL_COUNTER; break;
+            default: c.value = TimerMode::NA; break;
+        }
+        c.timestamp_us = e.timestamp_us;
+        c.valid = true;
+        return c;
+    }
+
+private:
+    // =============== Sequence Counter ===============
+
+    void begin_write() {
+#ifdef SONY9PINREMOTE_SENSE_CACHE_SEQLOCK
+        seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+#endif
+    }
+    void end_write() {
+#ifdef SONY9PINREMOTE_SENSE_CACHE_SEQLOCK
+        seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+#endif
+    }
+
+    // copy the entry of `cmd2` as it was between two stores
+    bool snapshot(const uint8_t cmd2, Entry& out) const {
+#ifdef SONY9PINREMOTE_SENSE_CACHE_SEQLOCK
+        while (true) {
+            const uint32_t begin = seq.load(std::memory_order_acquire);
+            if (begin & 1) continue;
+            const Entry* e = find(cmd2);
+            if (e) out = *e;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == begin) return e != nullptr;
+        }
+#else
+        const Entry* e = find(cmd2);
+        if (e) out = *e;
+        return e != nullptr;
+#endif
+    }
+
+    void copy_to(SenseCache& dst) const {
+#ifdef SONY9PINREMOTE_SENSE_CACHE_SEQLOCK
+        while (true) {
+            const uint32_t begin = seq.load(std::memory_order_acquire);
+            if (begin & 1) continue;
+            memcpy(dst.entries, entries, sizeof(entries));
+            dst.used = used;
+            dst.n_evicted = n_evicted;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == begin) return;
+        }
+#else
+        memcpy(dst.entries, entries, sizeof(entries));
+        dst.used = used;
+        dst.n_evicted = n_evicted;
+#endif
+    }
+
+    Entry* find(const uint8_t cmd2) {
+        for (size_t i = 0; i < used; ++i)
+            if (entries[i].cmd2 == cmd2) return &entries[i];
+        return nullptr;
+    }
+    const Entry* find(const uint8_t cmd2) const {
+        const size_t n = (used < N) ? used : N;  // `used` may be read while being written
+        for (size_t i = 0; i < n; ++i)
+            if (entries[i].cmd2 == cmd2) return &entries[i];
+        return nullptr;
+    }
+
+    Entry* assign(const uint32_t now_us) {
+        if (used < N) return &entries[used++];
+        // the oldest one (compared by age so that the clock can wrap around)
+        size_t oldest = 0;
+        for (size_t i = 1; i < N; ++i)
+            if ((uint32_t)(now_us - entries[i].timestamp_us) > (uint32_t)(now_us - entries[oldest].timestamp_us)) oldest = i;
+        ++n_evicted;
+        return &entries[oldest];
+    }
+
+    Cached<UserBits> newer_userbits(const uint8_t tc_ub_cmd2, const uint8_t ub_cmd2) const {
+        const Cached<UserBits> ub = userbits(ub_cmd2);
+        const Cached<TimeCodeAndUserBits> tcub = timecode_userbits(tc_ub_cmd2);
+        if (!tcub.valid || (ub.valid && (int32_t)(ub.timestamp_us - tcub.timestamp_us) >= 0)) return ub;
+        Cached<UserBits> c;
+        c.value = tcub.value.ub;
+        c.timestamp_us = tcub.timestamp_us;
+        c.valid = true;
+        return c;
+    }
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_SENSE_CACHE_H
@@ -0,0 +1,233 @@
+#pragma once
+#ifndef SONY9PINREMOTE_TIMECODE_H
+#define SONY9PINREMOTE_TIMECODE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+
+#include "Types.h"
+
+// Use binary subtraction instead of `/` and `%` in the timecode arithmetic.
+// AVR has no hardware divider, and the quotients here are small (at most 12 bits), so a bounded
+// shift-and-subtract loop replaces the generic 32-bit division routine. Hosts use the hardware divider.
+#ifndef SONY9PINREMOTE_TIMECODE_BINARY_DIVISION
+#ifdef __AVR__
+#define SONY9PINREMOTE_TIMECODE_BINARY_DIVISION 1
+#else
+#define SONY9PINREMOTE_TIMECODE_BINARY_DIVISION 0
+#endif
+#endif
+
+namespace sony9pin {
+
+// Arithmetic of `TimeCode` based on the absolute frame count from 00:00:00:00.
+// Drop frame (DF) is applied if `TimeCode::is_df` is set and the rate is 29.97 or 59.94.
+// Every function is constexpr (C++11 single-expression recursion), and every quotient is
+// computed once and passed down as a parameter.
+namespace timecode {
+
+    // =============== Rate Table ===============
+
+    namespace detail {
+
+        // indexed by FrameRate: NONE, 23.976, 24, 25, 29.97, 30, 50, 59.94, 60
+        // (a class template so that the arrays can be defined in the header)
+        template <typename T = void>
+        struct RateTable {
+            // frames per second which is used to count the frames in the timecode
+            static constexpr uint8_t nominal_fps[9] {0, 24, 24, 25, 30, 30, 50, 60, 60};
+            // number of frame labels dropped at every minute except 00, 10, 20, 30, 40 and 50
+            static constexpr uint8_t drop_frames[9] {0, 0, 0, 0, 2, 0, 0, 4, 0};
+        };
+        template <typename T>
+        constexpr uint8_t RateTable<T>::nominal_fps[9];
+        template <typename T>
+        constexpr uint8_t RateTable<T>::drop_frames[9];
+        static_assert((uint8_t)FrameRate::FPS_60 == 8, "RateTable must have one entry per FrameRate");
+
+    }  // namespace detail
+
+    constexpr uint8_t nominal_fps(const FrameRate fps) {
+        return detail::RateTable<>::nominal_fps[(uint8_t)fps];
+    }
+
+    constexpr uint8_t drop_frames(const FrameRate fps) {
+        return detail::RateTable<>::drop_frames[(uint8_t)fps];
+    }
+
+    constexpr bool is_drop_frame_rate(const FrameRate fps) {
+        return drop_frames(fps) != 0;
+    }
+
+    constexpr uint8_t drop_frames(const FrameRate fps, const bool df) {
+        return df ? drop_frames(fps) : 0;
+    }
+
+    constexpr uint32_t frames_per_minute(const FrameRate fps, const bool df) {
+        return (uint32_t)nominal_fps(fps) * 60 - drop_frames(fps, df);
+    }
+
+    constexpr uint32_t frames_per_10_minutes(const FrameRate fps, const bool df) {
+        return (uint32_t)nominal_fps(fps) * 600 - 9 * drop_frames(fps, df);
+    }
+
+    constexpr uint32_t frames_per_day(const FrameRate fps, const bool df) {
+        return frames_per_10_minutes(fps, df) * 6 * 24;
+    }
+
+    namespace detail {
+
+        // Quotient of n / d by binary subtraction. The quotient must be less than 2^(bit + 1).
+        constexpr uint32_t bin_div(const uint32_t n, const uint32_t d, const uint8_t bit) {
+            return ((n >> bit) >= d)
+                     ? ((uint32_t)1 << bit) + (bit ? bin_div(n - (d << bit), d, bit - 1) : 0)
+                     : (bit ? bin_div(n, d, bit - 1) : 0);
+        }
+
+        // n / d whose quotient is less than 2^(bit + 1)
+        constexpr uint32_t div(const uint32_t n, const uint32_t d, const uint8_t bit) {
+#if SONY9PINREMOTE_TIMECODE_BINARY_DIVISION
+            return bin_div(n, d, bit);
+#else
+            return ((void)bit, n / d);
+#endif
+        }
+
+        // n % d for any n (the quotient is less than 2^12 for every frame count of uint32_t)
+        constexpr uint32_t mod(const uint32_t n, const uint32_t d) {
+#if SONY9PINREMOTE_TIMECODE_BINARY_DIVISION
+            return n - d * bin_div(n, d, 11);
+#else
+            return n % d;
+#endif
+        }
+
+        // ===== frame count -> NDF labels =====
+
+        // f: frames in the minute, ss: f / fps
+        constexpr TimeCode split_s(const uint8_t hh, const uint8_t mm, const uint32_t f, const uint32_t fps, const bool df, const uint32_t ss) {
+            return TimeCode::hmsf(hh, mm, (uint8_t)ss, (uint8_t)(f - fps * ss), false, df);
+        }
+        // f: frames in the hour, mm: f / (fps * 60)
+        constexpr TimeCode split_m(const uint8_t hh, const uint32_t f, const uint32_t fps, const bool df, const uint32_t mm) {
+            return split_s(hh, (uint8_t)mm, f - fps * 60 * mm, fps, df, div(f - fps * 60 * mm, fps, 5));
+        }
+        // f: frames in the day, hh: f / (fps * 3600)
+        constexpr TimeCode split_h(const uint32_t f, const uint32_t fps, const bool df, const uint32_t hh) {
+            return split_m((uint8_t)hh, f - fps * 3600 * hh, fps, df, div(f - fps * 3600 * hh, fps * 60, 5));
+        }
+        constexpr TimeCode split(const uint32_t f, const uint32_t fps, const bool df) {
+            return split_h(f, fps, df, div(f, fps * 3600, 4));
+        }
+
+        // ===== DF frame count -> frame count as if NDF =====
+
+        // rem: frames in the 10 minutes, whose first minute has no dropped label
+        constexpr uint32_t add_dropped_in_10_minutes(const uint32_t f, const uint32_t d, const uint32_t rem, const uint32_t fpm) {
+            return f + ((rem > d) ? d * div(rem - d, fpm, 3) : 0);
+        }
+        // tens: f / fp10m
+        constexpr uint32_t add_dropped(const uint32_t f, const uint32_t d, const uint32_t fp10m, const uint32_t fpm, const uint32_t tens) {
+            return add_dropped_in_10_minutes(f + 9 * d * tens, d, f - fp10m * tens, fpm);
+        }
+        constexpr uint32_t to_label_frames(const uint32_t f, const uint32_t d, const uint32_t fp10m, const uint32_t fpm) {
+            return add_dropped(f, d, fp10m, fpm, div(f, fp10m, 7));
+        }
+        constexpr uint32_t to_label_frames(const uint32_t f, const FrameRate fps, const bool df) {
+            return to_label_frames(f, drop_frames(fps, df), frames_per_10_minutes(fps, df), frames_per_minute(fps, df));
+        }
+
+        // ===== labels -> frame count =====
+
+        // total_minutes is up to 255 * 60 + 255 (fields counted as is), so the quotient is less than 2^11
+        constexpr uint32_t minutes_with_drop(const uint32_t total_minutes) {
+            return total_minutes - div(total_minutes, 10, 10);
+        }
+
+        constexpr uint32_t wrap_negative(const uint32_t m, const uint32_t fpd) {
+            return (m == 0) ? 0 : fpd - m;
+        }
+        constexpr uint32_t wrap(const int32_t f, const uint32_t fpd) {
+            return (f >= 0) ? mod((uint32_t)f, fpd) : wrap_negative(mod((uint32_t)(-f), fpd), fpd);
+        }
+
+        // the first two (or four) labels of every minute except each tenth are skipped in DF
+        constexpr bool is_dropped_label(const TimeCode& tc, const FrameRate fps) {
+            return tc.is_df && is_drop_frame_rate(fps) && (tc.second == 0) && (tc.frame < drop_frames(fps))
+                && (tc.minute != 10 * div(tc.minute, 10, 4));
+        }
+
+        constexpr int8_t compare_frames(const uint32_t a, const uint32_t b) {
+            return (a < b) ? -1 : (a > b) ? 1 : 0;
+        }
+
+    }  // namespace detail
+
+    // =============== Conversion ===============
+
+    // absolute frame count from 00:00:00:00 (fields out of range are counted as is)
+    constexpr uint32_t to_frames(const TimeCode& tc, const FrameRate fps) {
+        return ((uint32_t)tc.hour * 3600 + (uint32_t)tc.minute * 60 + tc.second) * nominal_fps(fps) + tc.frame
+             - drop_frames(fps, tc.is_df) * detail::minutes_with_drop((uint32_t)tc.hour * 60 + tc.minute);
+    }
+
+    // timecode of the absolute frame count (wrapped around 24 hours)
+    constexpr TimeCode from_frames(const uint32_t frames, const FrameRate fps, const bool df = false) {
+        return detail::split(
+            detail::to_label_frames(detail::mod(frames, frames_per_day(fps, df)), fps, df),
+            nominal_fps(fps),
+            df && is_drop_frame_rate(fps));
+    }
+
+    // =============== Validation / Normalization ===============
+
+    constexpr bool is_valid(const TimeCode& tc, const FrameRate fps) {
+        return (nominal_fps(fps) != 0) && (tc.hour < 24) && (tc.minute < 60) && (tc.second < 60)
+            && (tc.frame < nominal_fps(fps)) && !detail::is_dropped_label(tc, fps);
+    }
+
+    // Carry the fields out of range and wrap around 24 hours.
+    // The dropped DF labels (e.g. 00:01:00;00) are moved to the next valid one (00:01:00;02).
+    constexpr TimeCode normalize(const TimeCode& tc, const FrameRate fps) {
+        return from_frames(
+            detail::is_dropped_label(tc, fps) ? to_frames(tc, fps) + drop_frames(fps) - tc.frame : to_frames(tc, fps),
+            fps,
+            tc.is_df);
+    }
+
+    // =============== Arithmetic ===============
+
+    // timecode moved by the number of frames (wrapped around 24 hours)
+    constexpr TimeCode add(const TimeCode& tc, const int32_t frames, const FrameRate fps) {
+        return from_frames(
+            detail::wrap((int32_t)to_frames(tc, fps) + frames, frames_per_day(fps, tc.is_df)),
+            fps,
+            tc.is_df);
+    }
+
+    // add the duration to the timecode (e.g. in point + duration = out point)
+    constexpr TimeCode add(const TimeCode& tc, const TimeCode& duration, const FrameRate fps) {
+        return add(tc, (int32_t)to_frames(duration, fps), fps);
+    }
+
+    constexpr TimeCode sub(const TimeCode& tc, const int32_t frames, const FrameRate fps) {
+        return add(tc, -frames, fps);
+    }
+
+    // number of frames from b to a (negative if a is earlier than b)
+    constexpr int32_t diff(const TimeCode& a, const TimeCode& b, const FrameRate fps) {
+        return (int32_t)to_frames(a, fps) - (int32_t)to_frames(b, fps);
+    }
+
+    // -1 if a < b, 0 if a == b, 1 if a > b
+    constexpr int8_t compare(const TimeCode& a, const TimeCode& b, const FrameRate fps) {
+        return detail::compare_frames(to_frames(a, fps), to_frames(b, fps));
+    }
+
+}  // namespace timecode
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_TIMECODE_H
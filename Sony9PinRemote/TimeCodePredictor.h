@@ -0,0 +1,184 @@
+#pragma once
+#ifndef SONY9PINREMOTE_TIMECODE_PREDICTOR_H
+#define SONY9PINREMOTE_TIMECODE_PREDICTOR_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+
+#include "Types.h"
+#include "TimeCode.h"
+
+namespace sony9pin {
+
+// error of the prediction against the actual timecode replies [frames]
+struct PredictionStats {
+    uint32_t count {0};
+    int32_t last_error {0};  // actual - predicted
+    uint32_t max_abs_error {0};
+    uint64_t total_abs_error {0};
+
+    void add(const int32_t err) {
+        const uint32_t abs_err = (err < 0) ? (uint32_t)(-err) : (uint32_t)err;
+        ++count;
+        last_error = err;
+        if (abs_err > max_abs_error) max_abs_error = abs_err;
+        total_abs_error += abs_err;
+    }
+    // mean absolute error in 1/100 frames
+    uint32_t mean_abs_error_x100() const { return count ? (uint32_t)(total_abs_error * 100 / count) : 0; }
+};
+
+// Extrapolates the current timecode from the last timecode reply (anchor)
+// and the transport mode in the status, so that the timecode does not need to be polled every frame.
+// All timestamps are in microseconds of the clock of the Controller (see Clock.h).
+// The replies are keyed by their source (Cmd2 of the sense return, e.g. SenseReturn::LTC_TC):
+// the prediction follows the latest reply, but the speed and the error are measured only between
+// two replies of the same source, because LTC, VITC and the timers of a device are not in sync.
+class TimeCodePredictor {
+    enum : int32_t { SPEED_ONE = 256 };  // 1x play speed in Q8
+    enum : uint8_t { NUM_SOURCES = 6 };  // TIMER-1/2, LTC, VITC, interpolated LTC, hold VITC
+
+    // the last reply of each source
+    struct SourceAnchor {
+        uint32_t frames {0};
+        uint32_t us {0};
+        bool b_valid {false};
+        bool b_df {false};
+    };
+
+public:
+    static constexpr uint8_t ANY_SOURCE {0xFF};
+    // The elapsed time is signed 32 bit [us] (wraps after about 35.8 minutes),
+    // so an anchor older than this is stale and is not extrapolated any more.
+    static constexpr uint32_t MAX_ANCHOR_AGE_US {30ul * 60 * 1000000};
+
+private:
+    FrameRate rate {FrameRate::NONE};
+    uint8_t source_filter {ANY_SOURCE};
+    uint8_t anchor_source {ANY_SOURCE};
+    bool b_anchored {false};
+    TimeCode anchor_tc;
+    uint32_t anchor_frames {0};
+    uint32_t anchor_us {0};
+    int32_t measured_speed {0};  // speed between the last two replies of the same source (Q8)
+    SourceAnchor sources[NUM_SOURCES];
+    PredictionStats stats;
+
+public:
+    void set_frame_rate(const FrameRate fps) {
+        rate = fps;
+        reset();
+    }
+
+    void reset() {
+        b_anchored = false;
+        anchor_source = ANY_SOURCE;
+        measured_speed = 0;
+        for (auto& a : sources) a = SourceAnchor();
+    }
+
+    // Only the replies of `source` are used as anchors (ANY_SOURCE to accept all).
+    void set_source(const uint8_t source) {
+        source_filter = source;
+        reset();
+    }
+    uint8_t get_source() const { return source_filter; }
+    uint8_t last_anchor_source() const { return anchor_source; }
+
+    // Update the anchor with the timecode of `source` which was valid at `at_us`.
+    // The difference from the prediction made from the previous reply of the same source is added to the stats.
+    // Without the frame rate, the timecode is only kept to be returned as is by `predict()`.
+    void anchor(const TimeCode& tc, const uint32_t at_us, const RawStatus& sts, const uint8_t source) {
+        if (source_filter != ANY_SOURCE && source != source_filter) return;
+        anchor_tc = tc;
+        anchor_us = at_us;
+        anchor_source = source;
+        b_anchored = true;
+        if (rate == FrameRate::NONE) return;
+
+        anchor_frames = timecode::to_frames(tc, rate);
+        const uint8_t i = source_index(source);
+        if (i == NUM_SOURCES) return;
+        SourceAnchor& prev = sources[i];
+        if (prev.b_valid && prev.b_df == tc.is_df && (uint32_t)(at_us - prev.us) <= MAX_ANCHOR_AGE_US) {
+            const int32_t dt = (int32_t)(at_us - prev.us);
+            const int32_t actual = wrap_diff(anchor_frames, prev.frames, tc.is_df);
+            // predicted with the speed measured so far, before it is updated by this reply
+            const int32_t predicted = frames_after(dt, sts);
+            if (dt > 0)
+                measured_speed = (int32_t)((int64_t)actual * SPEED_ONE * frame_interval_us(rate) / dt);
+            stats.add(actual - predicted);
+        }
+        prev.frames = anchor_frames;
+        prev.us = at_us;
+        prev.b_df = tc.is_df;
+        prev.b_valid = true;
+    }
+
+    bool anchored() const { return b_anchored; }
+    // no reply for more than MAX_ANCHOR_AGE_US
+    bool stale(const uint32_t now_us) const { return b_anchored && (uint32_t)(now_us - anchor_us) > MAX_ANCHOR_AGE_US; }
+    const TimeCode& last_anchor() const { return anchor_tc; }
+
+    // returns the last anchor as is if the frame rate is not set or the anchor is stale
+    TimeCode predict(const uint32_t now_us, const RawStatus& sts) const {
+        if (!b_anchored || rate == FrameRate::NONE || stale(now_us)) return anchor_tc;
+        return timecode::add(anchor_tc, predict_frames(now_us, sts), rate);
+    }
+
+    // playback speed assumed from the status (Q8, 256 = 1x, negative = reverse)
+    int32_t speed(const RawStatus& sts) const {
+        if (sts.still() || sts.stop() || sts.eject())
+            return 0;
+        if (sts.play() && !(sts.var() || sts.shuttle() || sts.jog()))
+            return sts.direction() ? -SPEED_ONE : SPEED_ONE;
+        if (sts.var() || sts.shuttle() || sts.jog() || sts.forward() || sts.rewind())
+            return measured_speed;
+        return 0;
+    }
+
+    const PredictionStats& error() const { return stats; }
+    void reset_error() { stats = PredictionStats(); }
+
+private:
+    // frames elapsed since the anchor
+    int32_t predict_frames(const uint32_t now_us, const RawStatus& sts) const {
+        return frames_after((int32_t)(now_us - anchor_us), sts);
+    }
+
+    // frames elapsed in `dt` us at the speed assumed from the status
+    int32_t frames_after(const int32_t dt, const RawStatus& sts) const {
+        if (dt <= 0) return 0;
+        const int64_t q = (int64_t)speed(sts) * dt;
+        const int64_t d = (int64_t)SPEED_ONE * frame_interval_us(rate);
+        // round to the nearest frame
+        return (int32_t)((q >= 0) ? (q + d / 2) / d : (q - d / 2) / d);
+    }
+
+    // a - b wrapped into +-12 hours
+    int32_t wrap_diff(const uint32_t a, const uint32_t b, const bool is_df) const {
+        const int32_t fpd = (int32_t)timecode::frames_per_day(rate, is_df);
+        int32_t d = (int32_t)a - (int32_t)b;
+        if (d > fpd / 2) d -= fpd;
+        if (d < -fpd / 2) d += fpd;
+        return d;
+    }
+
+    static uint8_t source_index(const uint8_t source) {
+        switch (source) {
+            case SenseReturn::TIMER_1: return 0;
+            case SenseReturn::TIMER_2: return 1;
+            case SenseReturn::LTC_TC: return 2;
+            case SenseReturn::VITC_TC: return 3;
+            case SenseReturn::LTC_INTERPOLATED_TC: return 4;
+            case SenseReturn::HOLD_VITC_TC: return 5;
+            default: return NUM_SOURCES;
+        }
+    }
+};
+
+}  // namespace sony9pin
+
+#endif  // SONY9PINREMOTE_TIMECODE_PREDICTOR_H
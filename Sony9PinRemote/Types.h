@@ -423,6 +423,123 @@ struct Status {
     bool b_fnc_abort {false};
 };
 
+// List of all status bits as (byte, StatusMask, name of Status member without "b_")
+#define SONY9PIN_STATUS_BITS(X)                \
+    X(0, CASSETTE_OUT, cassette_out)           \
+    X(0, SERVO_REF_MISSING, servo_ref_missing) \
+    X(0, LOCAL, local)                         \
+    X(1, STANDBY, standby)                     \
+    X(1, STOP, stop)                           \
+    X(1, EJECT, eject)                         \
+    X(1, REWIND, rewind)                       \
+    X(1, FORWARD, forward)                     \
+    X(1, RECORD, record)                       \
+    X(1, PLAY, play)                           \
+    X(2, SERVO_LOCK, servo_lock)               \
+    X(2, TSO_MODE, tso_mode)                   \
+    X(2, SHUTTLE, shuttle)                     \
+    X(2, JOG, jog)                             \
+    X(2, VAR, var)                             \
+    X(2, DIRECTION, direction)                 \
+    X(2, STILL, still)                         \
+    X(2, CUE_UP, cue_up)                       \
+    X(3, AUTO_MODE, auto_mode)                 \
+    X(3, FREEZE_ON, freeze_on)                 \
+    X(3, CF_MODE, cf_mode)                     \
+    X(3, AUDIO_OUT_SET, audio_out_set)         \
+    X(3, AUDIO_IN_SET, audio_in_set)           \
+    X(3, OUT_SET, out_set)                     \
+    X(3, IN_SET, in_set)                       \
+    X(4, SELECT_EE, select_ee)                 \
+    X(4, FULL_EE, full_ee)                     \
+    X(4, EDIT_SET, edit)                       \
+    X(4, REVIEW_SET, review)                   \
+    X(4, AUTO_EDIT_SET, auto_edit)             \
+    X(4, PREVIEW_SET, preview)                 \
+    X(4, PREROLL_SET, preroll)                 \
+    X(5, INSERT_SET, insert)                   \
+    X(5, ASSEMBLE_SET, assemble)               \
+    X(5, VIDEO_SET, video)                     \
+    X(5, A4_SET, a4)                           \
+    X(5, A3_SET, a3)                           \
+    X(5, A2_SET, a2)                           \
+    X(5, A1_SET, a1)                           \
+    X(6, LAMP_STILL, lamp_still)               \
+    X(6, LAMP_FWD, lamp_fwd)                   \
+    X(6, LAMP_REV, lamp_rev)                   \
+    X(6, SRCH_LED_8, srch_led_8)               \
+    X(6, SRCH_LED_4, srch_led_4)               \
+    X(6, SRCH_LED_2, srch_led_2)               \
+    X(6, SRCH_LED_1, srch_led_1)               \
+    X(7, AUD_SPLIT, aud_split)                 \
+    X(7, SYNC_ACT, sync_act)                   \
+    X(7, SPOT_ERASE, spot_erase)               \
+    X(7, IN_OUT, in_out)                       \
+    X(8, BUZZER, buzzer)                       \
+    X(8, LOST_LOCK, lost_lock)                 \
+    X(8, NEAR_EOT, near_eot)                   \
+    X(8, EOT, eot)                             \
+    X(8, CF_LOCK, cf_lock)                     \
+    X(8, SVO_ALARM, svo_alarm)                 \
+    X(8, SYS_ALARM, sys_alarm)                 \
+    X(8, REC_INHIB, rec_inhib)                 \
+    X(9, FNC_ABORT, fnc_abort)
+
+// Raw 10 bytes of 74.20 STATUS DATA.
+// Copying and comparing this is much cheaper than `Status`
+// and every bit can be read by the accessor which has the same name as `Status` member.
+struct RawStatus {
+    static constexpr uint8_t SIZE {10};
+    uint8_t bytes[SIZE];
+
+    constexpr RawStatus() : bytes {} {}
+
+#define SONY9PIN_STATUS_ACCESSOR(byte, mask, name) \
+    constexpr bool name() const { return (bytes[byte] & StatusMask::mask) != 0; }
+    SONY9PIN_STATUS_BITS(SONY9PIN_STATUS_ACCESSOR)
+#undef SONY9PIN_STATUS_ACCESSOR
+
+    Status to_status() const {
+        Status sts;
+#define SONY9PIN_STATUS_UNPACK(byte, mask, name) sts.b_##name = name();
+        SONY9PIN_STATUS_BITS(SONY9PIN_STATUS_UNPACK)
+#undef SONY9PIN_STATUS_UNPACK
+        return sts;
+    }
+
+    bool operator==(const RawStatus& rhs) const {
+        for (uint8_t i = 0; i < SIZE; ++i)
+            if (bytes[i] != rhs.bytes[i]) return false;
+        return true;
+    }
+    bool operator!=(const RawStatus& rhs) const { return !(*this == rhs); }
+};
+
+// position of the bit in RawStatus (byte * 8 + bit)
+constexpr uint8_t status_bit_index(const uint8_t byte, const uint8_t mask, const uint8_t bit = 0) {
+    return (bit >= 8 || ((mask >> bit) & 1)) ? byte * 8 + bit : status_bit_index(byte, mask, bit + 1);
+}
+
+// every status bit named after its StatusMask
+enum class StatusBit : uint8_t {
+#define SONY9PIN_STATUS_ENUM(byte, mask, name) mask = status_bit_index(byte, StatusMask::mask),
+    SONY9PIN_STATUS_BITS(SONY9PIN_STATUS_ENUM)
+#undef SONY9PIN_STATUS_ENUM
+};
+
+// one status bit which has flipped between two STATUS DATA replies
+struct StatusEvent {
+    StatusBit bit {StatusBit::CASSETTE_OUT};
+    bool value {false};       // new state of the bit (true: rising edge, false: falling edge)
+    uint32_t timestamp {0};  // time of the reply [us]
+
+    uint8_t byte() const { return (uint8_t)bit >> 3; }
+    uint8_t mask() const { return (uint8_t)(1 << ((uint8_t)bit & 0x07)); }
+};
+
+constexpr uint8_t from_bcd(const uint8_t n) { return n - 6 * (n >> 4); }
+constexpr uint8_t to_bcd(const uint8_t n) { return n + 6 * (n / 10); }
+
 struct TimeCode {
     uint8_t frame {0};
     uint8_t second {0};
@@ -430,6 +547,43 @@ struct TimeCode {
     uint8_t hour {0};
     bool is_cf {false};
     bool is_df {false};
+
+    // Arguments are in the member order (frame first), same as the aggregate init `TimeCode{ff, ss, mm, hh}`.
+    // Use `TimeCode::hmsf()` to write the timecode in the usual hour-first order.
+    // Both take the flags in the member order (CF, DF), and only both or none of them,
+    // so that a single bool (e.g. `hmsf(1, 0, 0, 0, true)`) does not compile instead of setting the wrong flag.
+    constexpr TimeCode() {}
+    constexpr TimeCode(const uint8_t ff, const uint8_t ss, const uint8_t mm, const uint8_t hh)
+    : frame(ff), second(ss), minute(mm), hour(hh) {}
+    constexpr TimeCode(const uint8_t ff, const uint8_t ss, const uint8_t mm, const uint8_t hh, const bool cf, const bool df)
+    : frame(ff), second(ss), minute(mm), hour(hh), is_cf(cf), is_df(df) {}
+
+    // hh:mm:ss:ff
+    static constexpr TimeCode hmsf(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff) {
+        return TimeCode(ff, ss, mm, hh);
+    }
+    static constexpr TimeCode hmsf(const uint8_t hh, const uint8_t mm, const uint8_t ss, const uint8_t ff, const bool cf, const bool df) {
+        return TimeCode(ff, ss, mm, hh, cf, df);
+    }
+
+    // 4 bytes of the time data format (CUE UP WITH DATA, TIME DATA returns etc.):
+    // FF SS MM HH in BCD with the CF / DF flags in bit 7 / 6 of FF
+    static TimeCode decode_bcd(const uint8_t* data) {
+        TimeCode tc;
+        tc.is_cf = data[0] & 0b10000000;
+        tc.is_df = data[0] & 0b01000000;
+        tc.frame = from_bcd(data[0] & 0x3F);
+        tc.second = from_bcd(data[1] & 0x7F);
+        tc.minute = from_bcd(data[2] & 0x7F);
+        tc.hour = from_bcd(data[3] & 0x3F);
+        return tc;
+    }
+    void encode_bcd(uint8_t* data) const {
+        data[0] = to_bcd(frame) | (is_df ? 0b01000000 : 0) | (is_cf ? 0b10000000 : 0);
+        data[1] = to_bcd(second);
+        data[2] = to_bcd(minute);
+        data[3] = to_bcd(hour);
+    }
 };
 
 union UserBits {
@@ -499,6 +653,34 @@ namespace StopMode {
     };
 }
 
+// =============== Frame Rate ===============
+
+// The device accepts only one command per frame (otherwise it returns NAK with BUFFER_OVERRUN)
+enum class FrameRate : uint8_t {
+    NONE,  // no pacing
+    FPS_23_976,
+    FPS_24,
+    FPS_25,
+    FPS_29_97,
+    FPS_30,
+    FPS_50,
+    FPS_59_94,
+    FPS_60,
+};
+
+// length of one frame in microseconds (rounded up)
+constexpr uint32_t frame_interval_us(const FrameRate fps) {
+    return (fps == FrameRate::FPS_23_976) ? 41709   // 1001 / 24000
+         : (fps == FrameRate::FPS_24)     ? 41667
+         : (fps == FrameRate::FPS_25)     ? 40000
+         : (fps == FrameRate::FPS_29_97)  ? 33367   // 1001 / 30000
+         : (fps == FrameRate::FPS_30)     ? 33334
+         : (fps == FrameRate::FPS_50)     ? 20000
+         : (fps == FrameRate::FPS_59_94)  ? 16684   // 1001 / 60000
+         : (fps == FrameRate::FPS_60)     ? 16667
+                                          : 0;
+}
+
 }  // namespace sony9pin
 
 #endif  // HT_RS422_SONY9PINREMOTE_TYPES_H
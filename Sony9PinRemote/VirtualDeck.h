@@ -0,0 +1,602 @@
+#pragma once
+#ifndef SONY9PINREMOTE_VIRTUAL_DECK_H
+#define SONY9PINREMOTE_VIRTUAL_DECK_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "Types.h"
+#include "Commands.h"
+#include "Decoder.h"
+#include "TimeCode.h"
+
+#ifdef SONY9PINREMOTE_DEBUGLOG_ENABLE
+#include <DebugLogEnable.h>
+#else
+#include <DebugLogDisable.h>
+#endif
+
+namespace sony9pin {
+
+// Device side of the protocol: parses the commands from a controller and returns
+// correctly checksummed ACK / NAK / sense replies based on the simulated transport state.
+// It does not touch any stream; bytes from the controller are given to `feed()`,
+// and replies are taken by `read()`. Call `update()` with the current time to advance the timecode.
+// Every sense request in the command table is answered; the ones without simulated state
+// (e.g. EXTENDED VTR STATUS, REMAINING TIME, DA senses) return zeros of the size in the reply table.
+// The BlackMagic stop mode is stored (`get_stop_mode()`) but does not change the transport,
+// because it selects the video output after STOP, which is not simulated.
+//
+//     VirtualDeck deck;
+//     deck.update(micros());
+//     deck.feed(rx, rx_size);
+//     tx_size = deck.read(tx, sizeof(tx));
+class VirtualDeck {
+public:
+    enum class Transport : uint8_t {
+        STOP,
+        PLAY,
+        RECORD,
+        FAST_FORWARD,
+        REWIND,
+        JOG,
+        VAR,
+        SHUTTLE,
+        EJECT,
+    };
+
+private:
+    static constexpr size_t TX_BUFFER_SIZE {256};
+    enum : int32_t { SPEED_ONE = 256 };        // 1x play speed in Q8
+    enum : int32_t { SPEED_FAST = 256 * 16 };  // fast forward / rewind
+
+    Decoder decoder;
+    size_t n_decoder_lost {0};
+
+    uint8_t tx_buffer[TX_BUFFER_SIZE];
+    size_t tx_head {0};
+    size_t tx_tail {0};
+
+    // clock
+    FrameRate rate {FrameRate::FPS_29_97};
+    bool b_df {false};
+    uint32_t now_us {0};
+    bool b_clock_started {false};
+    int64_t sub_frame {0};  // elapsed time which has not been a frame yet [us * SPEED_ONE]
+
+    // transport
+    Transport transport {Transport::STOP};
+    int32_t speed {0};  // Q8, negative = reverse
+    uint32_t position {0};  // frames from 00:00:00:00
+    bool b_still {true};
+    bool b_cue_up {false};
+    bool b_local {false};
+    bool b_standby {true};
+    bool b_cassette_out {false};
+    bool b_auto_mode {false};
+    bool b_full_ee {false};
+    bool b_select_ee {false};
+
+    // presets
+    uint32_t in_point {0};
+    uint32_t out_point {0};
+    bool b_in_set {false};
+    bool b_out_set {false};
+    uint32_t preroll {0};
+    UserBits ub;
+    uint16_t dev_type {DeviceType::BLACKMAGIC_HYPERDECK_STUDIO_MINI_NTSC};
+    TimerMode timer_mode {TimerMode::TIME_CODE};
+    bool b_loop {false};
+    uint8_t loop_mode {LoopMode::SINGLE_CLIP};
+    uint8_t stop_mode {StopMode::OFF};
+
+    // errors
+    bool b_strict_pacing {false};
+    bool b_received {false};
+    uint32_t last_command_us {0};
+    size_t n_commands {0};
+    size_t n_naks {0};
+
+public:
+    explicit VirtualDeck(const FrameRate fps = FrameRate::FPS_29_97, const bool df = false) {
+        decoder.accept_commands();
+        set_frame_rate(fps, df);
+    }
+
+    // =============== Configuration ===============
+
+    void set_frame_rate(const FrameRate fps, const bool df = false) {
+        rate = (fps == FrameRate::NONE) ? FrameRate::FPS_29_97 : fps;
+        b_df = df && timecode::is_drop_frame_rate(rate);
+        preroll = timecode::nominal_fps(rate) * 5;  // 5 sec
+    }
+    void set_device_type(const uint16_t type) { dev_type = type; }
+    void set_timecode(const TimeCode& tc) { position = timecode::to_frames(with_df(tc), rate); }
+    // return NAK (BUFFER_OVERRUN) if more than one command is received in one frame
+    void set_strict_frame_pacing(const bool b) { b_strict_pacing = b; }
+
+    // =============== Stream ===============
+
+    // advance the simulated clock (the first call only starts it)
+    void update(const uint32_t us) {
+        if (!b_clock_started) {
+            b_clock_started = true;
+            now_us = us;
+            return;
+        }
+        const int32_t dt = (int32_t)(us - now_us);
+        now_us = us;
+        if (dt <= 0 || speed == 0) return;
+
+        sub_frame += (int64_t)dt * speed;
+        const int64_t unit = (int64_t)SPEED_ONE * frame_interval_us(rate);
+        const int64_t frames = sub_frame / unit;
+        sub_frame -= frames * unit;
+        if (frames != 0) move((int32_t)frames);
+    }
+
+    // parse bytes from the controller, returns the number of commands processed
+    size_t feed(const uint8_t* data, const size_t size) {
+        size_t n = 0;
+        for (size_t i = 0; i < size; ++i)
+            if (feed(data[i])) ++n;
+        return n;
+    }
+
+    bool feed(const uint8_t d) {
+        const bool b_packet = decoder.feed(d);
+        if (decoder.lost_count() != n_decoder_lost) {
+            n_decoder_lost = decoder.lost_count();
+            nak(NakMask::CHECKSUM_ERROR);
+            return false;
+        }
+        if (!b_packet) return false;
+        ++n_commands;
+        if (b_strict_pacing && b_received && ((now_us - last_command_us) < frame_interval_us(rate))) {
+            last_command_us = now_us;
+            nak(NakMask::BUFFER_OVERRUN);
+            return true;
+        }
+        b_received = true;
+        last_command_us = now_us;
+        process();
+        return true;
+    }
+
+    // replies to the controller
+    size_t available() const { return tx_tail - tx_head; }
+    size_t read(uint8_t* data, const size_t size) {
+        size_t n = 0;
+        while (n < size && tx_head != tx_tail)
+            data[n++] = tx_buffer[tx_head++ % TX_BUFFER_SIZE];
+        return n;
+    }
+
+    // =============== State ===============
+
+    TimeCode timecode() const { return timecode::from_frames(position, rate, b_df); }
+    uint32_t frames() const { return position; }
+    Transport transport_mode() const { return transport; }
+    int32_t speed_q8() const { return speed; }
+    bool is_local() const { return b_local; }
+    TimeCode in_point_timecode() const { return timecode::from_frames(in_point, rate, b_df); }
+    TimeCode out_point_timecode() const { return timecode::from_frames(out_point, rate, b_df); }
+    bool is_in_set() const { return b_in_set; }
+    bool is_out_set() const { return b_out_set; }
+    bool is_loop_enabled() const { return b_loop; }
+    uint8_t get_loop_mode() const { return loop_mode; }
+    uint8_t get_stop_mode() const { return stop_mode; }
+    size_t command_count() const { return n_commands; }
+    size_t nak_count() const { return n_naks; }
+
+    RawStatus raw_status() const {
+        RawStatus sts;
+        sts.bytes[0] = (b_cassette_out ? StatusMask::CASSETTE_OUT : 0) | (b_local ? StatusMask::LOCAL : 0);
+        sts.bytes[1] = (b_standby ? StatusMask::STANDBY : 0)
+                     | ((transport == Transport::STOP) ? StatusMask::STOP : 0)
+                     | ((transport == Transport::EJECT) ? StatusMask::EJECT : 0)
+                     | ((transport == Transport::REWIND) ? StatusMask::REWIND : 0)
+                     | ((transport == Transport::FAST_FORWARD) ? StatusMask::FORWARD : 0)
+                     | ((transport == Transport::RECORD) ? StatusMask::RECORD | StatusMask::PLAY : 0)
+                     | ((transport == Transport::PLAY) ? StatusMask::PLAY : 0);
+        sts.bytes[2] = ((transport == Transport::PLAY || transport == Transport::RECORD) ? StatusMask::SERVO_LOCK : 0)
+                     | ((transport == Transport::SHUTTLE) ? StatusMask::SHUTTLE : 0)
+                     | ((transport == Transport::JOG) ? StatusMask::JOG : 0)
+                     | ((transport == Transport::VAR) ? StatusMask::VAR : 0)
+                     | ((speed < 0) ? StatusMask::DIRECTION : 0)
+                     | (b_still ? StatusMask::STILL : 0)
+                     | (b_cue_up ? StatusMask::CUE_UP : 0);
+        sts.bytes[3] = (b_auto_mode ? StatusMask::AUTO_MODE : 0)
+                     | (b_out_set ? StatusMask::OUT_SET : 0)
+                     | (b_in_set ? StatusMask::IN_SET : 0);
+        sts.bytes[4] = (b_select_ee ? StatusMask::SELECT_EE : 0) | (b_full_ee ? StatusMask::FULL_EE : 0);
+        sts.bytes[6] = (b_still ? StatusMask::LAMP_STILL : 0)
+                     | ((speed > 0) ? StatusMask::LAMP_FWD : 0)
+                     | ((speed < 0) ? StatusMask::LAMP_REV : 0);
+        return sts;
+    }
+
+private:
+    // =============== Command Processing ===============
+
+    void process() {
+        // commands which are unknown or have the wrong number of data bytes are rejected as a real deck does
+        if (!command_info((uint8_t)decoder.cmd1() | decoder.size(), decoder.cmd2()).accepts(decoder.size())) {
+            nak(NakMask::UNKNOWN_CMD);
+            return;
+        }
+        switch (decoder.cmd1()) {
+            case Cmd1::SYSTEM_CONTROL: process_system_control(); break;
+            case Cmd1::TRANSPORT_CONTROL: process_transport_control(); break;
+            case Cmd1::PRESET_SELECT_CONTROL: process_preset_select_control(); break;
+            case Cmd1::SENSE_REQUEST: process_sense_request(); break;
+            case Cmd1::BMD_EXTENSION: process_bmd_extension(); break;
+            case Cmd1::BMD_ADVANCED_MEDIA_PRTCL: process_bmd_advanced_media_protocol(); break;
+            default: nak(NakMask::UNKNOWN_CMD); break;
+        }
+    }
+
+    // ===== 0 - System Control =====
+    void process_system_control() {
+        switch (decoder.cmd2()) {
+            case SystemCtrl::LOCAL_DISABLE: b_local = false; ack(); break;
+            case SystemCtrl::LOCAL_ENABLE: b_local = true; ack(); break;
+            case SystemCtrl::DEVICE_TYPE: {
+                const uint8_t data[2] = {(uint8_t)(dev_type >> 8), (uint8_t)(dev_type & 0xFF)};
+                reply(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::DEVICE_TYPE, data, 2);
+                break;
+            }
+            case SystemCtrl::BMD_SEEK_TO_TIMELINE_POS: stop(); ack(); break;
+            default: nak(NakMask::UNKNOWN_CMD); break;
+        }
+    }
+
+    // ===== 2 - Transport Control =====
+    void process_transport_control() {
+        switch (decoder.cmd2()) {
+            case TransportCtrl::STOP: stop(); break;
+            case TransportCtrl::PLAY: run(Transport::PLAY, SPEED_ONE); break;
+            case TransportCtrl::RECORD: run(Transport::RECORD, SPEED_ONE); break;
+            case TransportCtrl::STANDBY_OFF: b_standby = false; stop(); break;
+            case TransportCtrl::STANDBY_ON: b_standby = true; break;
+            case TransportCtrl::EJECT: run(Transport::EJECT, 0); b_cassette_out = true; break;
+            case TransportCtrl::FAST_FWD: run(Transport::FAST_FORWARD, SPEED_FAST); break;
+            case TransportCtrl::JOG_FWD: run(Transport::JOG, speed_data()); break;
+            case TransportCtrl::VAR_FWD: run(Transport::VAR, speed_data()); break;
+            case TransportCtrl::SHUTTLE_FWD: run(Transport::SHUTTLE, speed_data()); break;
+            case TransportCtrl::FRAME_STEP_FWD: stop(); move(1); break;
+            case TransportCtrl::REWIND: run(Transport::REWIND, -SPEED_FAST); break;
+            case TransportCtrl::JOG_REV: run(Transport::JOG, -speed_data()); break;
+            case TransportCtrl::VAR_REV: run(Transport::VAR, -speed_data()); break;
+            case TransportCtrl::SHUTTLE_REV: run(Transport::SHUTTLE, -speed_data()); break;
+            case TransportCtrl::FRAME_STEP_REV: stop(); move(-1); break;
+            case TransportCtrl::PREROLL: cue(wrap(in_point, -(int32_t)preroll)); break;
+            case TransportCtrl::CUE_UP_WITH_DATA: {
+                if (decoder.size() < 4) {
+                    nak(NakMask::UNKNOWN_CMD);
+                    return;
+                }
+                cue(timecode::to_frames(with_df(timecode_data(0)), rate));
+                break;
+            }
+            case TransportCtrl::SYNC_PLAY: run(Transport::PLAY, SPEED_ONE); break;
+            case TransportCtrl::PROG_SPEED_PLAY_PLUS: run(Transport::VAR, speed_data()); break;
+            case TransportCtrl::PROG_SPEED_PLAY_MINUS: run(Transport::VAR, -speed_data()); break;
+            case TransportCtrl::PREVIEW:
+            case TransportCtrl::REVIEW:
+            case TransportCtrl::AUTO_EDIT:
+            case TransportCtrl::OUTPOINT_PREVIEW: position = in_point; run(Transport::PLAY, SPEED_ONE); break;
+            case TransportCtrl::DMC_SET_FWD:
+            case TransportCtrl::DMC_SET_REV:
+            case TransportCtrl::EDIT_OFF:
+            case TransportCtrl::EDIT_ON:
+            case TransportCtrl::FREEZE_OFF:
+            case TransportCtrl::FREEZE_ON:
+            case TransportCtrl::CLEAR_PLAYLIST: break;
+            case TransportCtrl::FULL_EE_OFF: b_full_ee = false; b_select_ee = false; break;
+            case TransportCtrl::FULL_EE_ON: b_full_ee = true; break;
+            case TransportCtrl::SELECT_EE_ON: b_select_ee = true; break;
+            default: nak(NakMask::UNKNOWN_CMD); return;
+        }
+        ack();
+    }
+
+    // ===== 4 - Preset/Select Control =====
+    void process_preset_select_control() {
+        const uint8_t cmd2 = decoder.cmd2();
+        // BlackMagic commands share cmd2 with SPOT ERASE OFF / AUDIO SPLIT OFF, but have data
+        const bool bmd = command_info((uint8_t)decoder.cmd1() | decoder.size(), cmd2).bmd();
+        if (bmd && cmd2 == PresetSelectCtrl::SET_PLAYBACK_LOOP) {
+            b_loop = decoder.data(0) & 0x01;
+            loop_mode = (decoder.data(0) >> 1) & 0x01;
+            ack();
+            return;
+        }
+        if (bmd && cmd2 == PresetSelectCtrl::SET_STOP_MODE) {
+            stop_mode = decoder.data(0);
+            ack();
+            return;
+        }
+
+        switch (cmd2) {
+            case PresetSelectCtrl::TIMER_1_PRESET:
+            case PresetSelectCtrl::TIME_CODE_PRESET: {
+                if (decoder.size() < 4) {
+                    nak(NakMask::UNKNOWN_CMD);
+                    return;
+                }
+                const TimeCode tc = timecode_data(0);
+                b_df = tc.is_df && timecode::is_drop_frame_rate(rate);
+                position = timecode::to_frames(with_df(tc), rate);
+                break;
+            }
+            case PresetSelectCtrl::USER_BIT_PRESET: {
+                for (uint8_t i = 0; i < 4 && i < decoder.size(); ++i) ub.bytes[i] = decoder.data(i);
+                break;
+            }
+            case PresetSelectCtrl::TIMER_1_RESET: position = 0; break;
+            case PresetSelectCtrl::IN_ENTRY: in_point = position; b_in_set = true; break;
+            case PresetSelectCtrl::OUT_ENTRY: out_point = position; b_out_set = true; break;
+            case PresetSelectCtrl::IN_DATA_PRESET:
+            case PresetSelectCtrl::OUT_DATA_PRESET:
+            case PresetSelectCtrl::PREROLL_PRESET: {
+                if (decoder.size() < 4) {
+                    nak(NakMask::UNKNOWN_CMD);
+                    return;
+                }
+                const uint32_t frames = timecode::to_frames(with_df(timecode_data(0)), rate);
+                if (cmd2 == PresetSelectCtrl::IN_DATA_PRESET) {
+                    in_point = frames;
+                    b_in_set = true;
+                } else if (cmd2 == PresetSelectCtrl::OUT_DATA_PRESET) {
+                    out_point = frames;
+                    b_out_set = true;
+                } else {
+                    preroll = frames;
+                }
+                break;
+            }
+            case PresetSelectCtrl::IN_SHIFT_PLUS: in_point = wrap(in_point, 1); break;
+            case PresetSelectCtrl::IN_SHIFT_MINUS: in_point = wrap(in_point, -1); break;
+            case PresetSelectCtrl::OUT_SHIFT_PLUS: out_point = wrap(out_point, 1); break;
+            case PresetSelectCtrl::OUT_SHIFT_MINUS: out_point = wrap(out_point, -1); break;
+            case PresetSelectCtrl::IN_FLAG_RESET: b_in_set = false; break;
+            case PresetSelectCtrl::OUT_FLAG_RESET: b_out_set = false; break;
+            case PresetSelectCtrl::IN_RECALL:
+            case PresetSelectCtrl::OUT_RECALL: break;
+            case PresetSelectCtrl::TIMER_MODE_SELECT: {
+                if (decoder.size() > 0) timer_mode = (TimerMode)decoder.data(0);
+                break;
+            }
+            case PresetSelectCtrl::AUTO_MODE_OFF: b_auto_mode = false; break;
+            case PresetSelectCtrl::AUTO_MODE_ON: b_auto_mode = true; break;
+            case PresetSelectCtrl::AUDIO_IN_ENTRY:
+            case PresetSelectCtrl::AUDIO_OUT_ENTRY:
+            case PresetSelectCtrl::AUDIO_IN_SHIFT_PLUS:
+            case PresetSelectCtrl::AUDIO_IN_SHIFT_MINUS:
+            case PresetSelectCtrl::AUDIO_OUT_SHIFT_PLUS:
+            case PresetSelectCtrl::AUDIO_OUT_SHIFT_MINUS:
+            case PresetSelectCtrl::AUDIO_IN_FLAG_RESET:
+            case PresetSelectCtrl::AUDIO_OUT_FLAG_RESET:
+            case PresetSelectCtrl::AUDIO_IN_RECALL:
+            case PresetSelectCtrl::AUDIO_OUT_RECALL:
+            case PresetSelectCtrl::LOST_LOCK_RESET:
+            case PresetSelectCtrl::EDIT_PRESET:
+            case PresetSelectCtrl::TAPE_AUDIO_SELECT:
+            case PresetSelectCtrl::SERVO_REF_SELECT:
+            case PresetSelectCtrl::HEAD_SELECT:
+            case PresetSelectCtrl::COLOR_FRAME_SELECT:
+            case PresetSelectCtrl::INPUT_CHECK:
+            case PresetSelectCtrl::EDIT_FIELD_SELECT:
+            case PresetSelectCtrl::FREEZE_MODE_SELECT:
+            case PresetSelectCtrl::SPOT_ERASE_OFF:
+            case PresetSelectCtrl::SPOT_ERASE_ON:
+            case PresetSelectCtrl::AUDIO_SPLIT_OFF:
+            case PresetSelectCtrl::AUDIO_SPLIT_ON:
+            case PresetSelectCtrl::STILL_OFF_TIME:
+            case PresetSelectCtrl::STBY_OFF_TIME: break;
+            default: nak(NakMask::UNKNOWN_CMD); return;
+        }
+        ack();
+    }
+
+    // ===== 6 - Sense Request =====
+    void process_sense_request() {
+        const uint8_t data1 = (decoder.size() > 0) ? decoder.data(0) : 0;
+        switch (decoder.cmd2()) {
+            case SenseRequest::TC_GEN_SENSE: {
+                if (data1 == TcGenData::TC_UB) timecode_userbits_reply(SenseReturn::GEN_TC_UB, timecode());
+                else if (data1 == TcGenData::UB) userbits_reply(SenseReturn::GEN_UB);
+                else timecode_reply(SenseReturn::GEN_TC, timecode());
+                break;
+            }
+            case SenseRequest::CURRENT_TIME_SENSE: current_time_reply(data1); break;
+            case SenseRequest::IN_DATA_SENSE: timecode_reply(SenseReturn::IN_DATA, in_point_timecode()); break;
+            case SenseRequest::OUT_DATA_SENSE: timecode_reply(SenseReturn::OUT_DATA, out_point_timecode()); break;
+            case SenseRequest::PREROLL_TIME_SENSE: timecode_reply(SenseReturn::PREROLL_TIME, timecode::from_frames(preroll, rate, b_df)); break;
+            case SenseRequest::STATUS_SENSE: {
+                const uint8_t start = data1 >> 4;
+                uint8_t size = data1 & 0x0F;
+                if (start >= RawStatus::SIZE) size = 0;
+                else if (start + size > RawStatus::SIZE) size = RawStatus::SIZE - start;
+                const RawStatus sts = raw_status();
+                reply(Cmd1::SENSE_RETURN, SenseReturn::STATUS_DATA, sts.bytes + start, size);
+                break;
+            }
+            case SenseRequest::TIMER_MODE_SENSE: {
+                const uint8_t data = (uint8_t)timer_mode;
+                reply(Cmd1::SENSE_RETURN, SenseReturn::TIMER_MODE_STATUS, &data, 1);
+                break;
+            }
+            default: {
+                const CommandInfo info = command_info((uint8_t)decoder.cmd1() | decoder.size(), decoder.cmd2());
+                if (info.reply == ReplyType::SENSE && info.reply_cmd2 != VARIABLE_REPLY)
+                    zero_reply(info.reply_cmd2, data1);
+                else
+                    nak(NakMask::UNKNOWN_CMD);
+                break;
+            }
+        }
+    }
+
+    // sense return without simulated state: zeros of the size in the reply table,
+    // or of the byte count in the LSD of DATA-1 (as STATUS SENSE) if the size depends on the request
+    void zero_reply(const uint8_t cmd2, const uint8_t data1) {
+        static const uint8_t zeros[0x0F] {};
+        uint8_t size = reply_info((uint8_t)Cmd1::SENSE_RETURN, cmd2).size;
+        if (size == VARIABLE_SIZE) size = (decoder.size() > 0) ? (data1 & 0x0F) : 1;
+        reply(Cmd1::SENSE_RETURN, cmd2, zeros, size);
+    }
+
+    // ===== 8 - BlackMagic Extensions =====
+    void process_bmd_extension() {
+        if (decoder.cmd2() == BmdExtensions::SEEK_RELATIVE_CLIP) {
+            stop();
+            ack();
+        } else {
+            nak(NakMask::UNKNOWN_CMD);
+        }
+    }
+
+    // ===== A - BlackMagic Advanced Media Protocol =====
+    void process_bmd_advanced_media_protocol() {
+        if (decoder.cmd2() == BmdAdvancedMediaProtocol::AUTO_SKIP)
+            ack();
+        else
+            nak(NakMask::UNKNOWN_CMD);
+    }
+
+    // =============== Transport ===============
+
+    void run(const Transport t, const int32_t spd) {
+        transport = t;
+        speed = spd;
+        b_still = (spd == 0);
+        b_cue_up = false;
+        b_cassette_out = false;
+        sub_frame = 0;
+    }
+
+    void stop() {
+        run(Transport::STOP, 0);
+    }
+
+    void cue(const uint32_t frames) {
+        stop();
+        position = frames;
+        b_cue_up = true;
+    }
+
+    void move(const int32_t frames) {
+        position = wrap(position, frames);
+        // loop between in and out point
+        if (b_loop && b_in_set && b_out_set && in_point < out_point && speed > 0 && position >= out_point)
+            position = in_point + (position - out_point);
+    }
+
+    uint32_t wrap(const uint32_t frames, const int32_t delta) const {
+        const int32_t fpd = (int32_t)timecode::frames_per_day(rate, b_df);
+        int32_t f = (int32_t)frames + delta;
+        while (f < 0) f += fpd;
+        while (f >= fpd) f -= fpd;
+        return (uint32_t)f;
+    }
+
+    // Speed data of JOG / VAR / SHUTTLE: N = 32 is 0.1x, 64 is 1x, 96 is 10x
+    int32_t speed_data() {
+        const uint8_t n = (decoder.size() > 0) ? decoder.data(0) : 64;
+        return (int32_t)(SPEED_ONE * pow(10.0, (double)n / 32.0 - 2.0));
+    }
+
+    // =============== Replies ===============
+
+    void ack() {
+        reply(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::ACK, nullptr, 0);
+    }
+
+    void nak(const uint8_t errors) {
+        ++n_naks;
+        reply(Cmd1::SYSTEM_CONTROL_RETURN, SystemControlReturn::NAK, &errors, 1);
+    }
+
+    void reply(const Cmd1 cmd1, const uint8_t cmd2, const uint8_t* data, const uint8_t size) {
+        const uint8_t header = (uint8_t)cmd1 | (size & 0x0F);
+        uint8_t crc = header + cmd2;
+        push(header);
+        push(cmd2);
+        for (uint8_t i = 0; i < size; ++i) {
+            push(data[i]);
+            crc += data[i];
+        }
+        push(crc);
+    }
+
+    void push(const uint8_t d) {
+        if (available() == TX_BUFFER_SIZE) {
+            LOG_WARN("VirtualDeck tx buffer overflow");
+            ++tx_head;
+        }
+        tx_buffer[tx_tail++ % TX_BUFFER_SIZE] = d;
+    }
+
+    void current_time_reply(const uint8_t flags) {
+        const TimeCode tc = timecode();
+        if ((flags & CurrentTimeSenseFlag::LTC_TC) && (flags & CurrentTimeSenseFlag::LTC_UB))
+            timecode_userbits_reply(SenseReturn::LTC_TC_UB, tc);
+        else if ((flags & CurrentTimeSenseFlag::VITC_TC) && (flags & CurrentTimeSenseFlag::VITC_UB))
+            timecode_userbits_reply(SenseReturn::VITC_TC_UB, tc);
+        else if (flags & CurrentTimeSenseFlag::LTC_TC)
+            timecode_reply(SenseReturn::LTC_TC, tc);
+        else if (flags & CurrentTimeSenseFlag::VITC_TC)
+            timecode_reply(SenseReturn::VITC_TC, tc);
+        else if (flags & CurrentTimeSenseFlag::TIMER_1)
+            timecode_reply(SenseReturn::TIMER_1, tc);
+        else if (flags & CurrentTimeSenseFlag::TIMER_2)
+            timecode_reply(SenseReturn::TIMER_2, tc);
+        else if (flags & CurrentTimeSenseFlag::LTC_UB)
+            userbits_reply(SenseReturn::LTC_UB);
+        else if (flags & CurrentTimeSenseFlag::VITC_UB)
+            userbits_reply(SenseReturn::VITC_UB);
+        else
+            nak(NakMask::UNKNOWN_CMD);
+    }
+
+    void timecode_reply(const uint8_t cmd2, const TimeCode& tc) {
+        uint8_t data[4];
+        tc.encode_bcd(data);
+        reply(Cmd1::SENSE_RETURN, cmd2, data, 4);
+    }
+
+    void timecode_userbits_reply(const uint8_t cmd2, const TimeCode& tc) {
+        uint8_t data[8];
+        tc.encode_bcd(data);
+        for (uint8_t i = 0; i < 4; ++i) data[4 + i] = ub.bytes[i];
+        reply(Cmd1::SENSE_RETURN, cmd2, data, 8);
+    }
+
+    void userbits_reply(const uint8_t cmd2) {
+        reply(Cmd1::SENSE_RETURN, cmd2, ub.bytes, 4);
+    }
+
+    // =============== Timecode Data ===============
+
+    TimeCode with_df(TimeCode tc) const {
+        tc.is_df = b_df;
+        return tc;
+    }
+
+    // DATA-1 to DATA-4 in the time data format (see TimeCode::decode_bcd())
+    TimeCode timecode_data(const uint8_t i) const {
+        return TimeCode::decode_bcd(decoder.data() + i);
+    }
+};
+
+}  // namespace sony9pin
+
+#include <DebugLogRestoreState.h>
+
+#endif  // SONY9PINREMOTE_VIRTUAL_DECK_H
@@ -0,0 +1,118 @@
+// Host test: issuing commands must not touch the heap in steady state.
+// Every allocation is counted by replacing the global operator new, then Encoder packets are built
+// and Controller commands are sent / acknowledged over a socket pair. Exits with 1 if anything allocated.
+//
+// Build (ArxContainer, ArxTypeTraits and DebugLog must be in the include path):
+//     g++ -std=c++11 -O2 -I../.. alloc_test.cpp -o alloc_test
+//
+// Usage:
+//     ./alloc_test [iterations]
+
+#include <Sony9PinRemote.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <new>
+
+using namespace Sony9PinRemote;
+
+namespace {
+size_t n_allocs {0};
+}  // namespace
+
+void* operator new(size_t size) {
+    ++n_allocs;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    ++n_allocs;
+    return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& t) noexcept { return operator new(size, t); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+bool check(const char* name, const size_t allocs, const size_t ops) {
+    printf("%-10s %8zu ops %8zu allocations %s\n", name, ops, allocs, allocs ? "FAIL" : "OK");
+    return allocs == 0;
+}
+
+// parameterless, BCD timecode and variadic commands
+bool test_encoder(const size_t iterations) {
+    Encoder encoder;
+    volatile uint8_t v = 0;
+    size_t sum = 0;
+    const size_t before = n_allocs;
+    for (size_t i = 0; i < iterations; ++i) {
+        const uint8_t f = (uint8_t)(i % 30);
+        sum += encoder.stop().size();
+        sum += encoder.status_sense().size();
+        sum += encoder.cue_up_with_data(1, 23, 45, f).size();
+        sum += encoder.in_data_preset(TimeCode::hmsf(1, 23, 45, f)).size();
+        sum += encoder.jog_forward(v, v).size();
+        sum += encoder.user_bit_preset(v, 0x22, 0x33, 0x44).size();
+        sum += encoder.current_time_sense(0x01).size();
+    }
+    v = (uint8_t)sum;
+    return check("encoder", n_allocs - before, iterations * 7);
+}
+
+// commands go through the queue, are written to a socket and acknowledged by the other end
+bool test_controller(const size_t iterations) {
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+        perror("socketpair");
+        return false;
+    }
+    PosixSerial port;
+    port.attach(sv[0], false);
+    Controller deck;
+    deck.attach(port);
+    deck.set_reply_timeout(1000);
+
+    static const uint8_t ACK[] {0x10, 0x01, 0x11};
+    static const uint8_t STATUS[] {0x74, 0x20, 0x00, 0x81, 0x80, 0x03, 0x98};
+    uint8_t rx[64];
+    bool ok = true;
+    auto round_trip = [&](const CommandId id, const uint8_t* reply, const size_t size) {
+        if (id == 0 || ::read(sv[1], rx, sizeof(rx)) <= 0 || ::write(sv[1], reply, size) != (ssize_t)size || !deck.parse_until(1000))
+            ok = false;
+    };
+
+    // the first round trip is excluded in case the platform allocates lazily (e.g. stdio)
+    round_trip(deck.play(), ACK, sizeof(ACK));
+    const size_t before = n_allocs;
+    for (size_t i = 0; ok && i < iterations; ++i) {
+        round_trip(deck.play(), ACK, sizeof(ACK));
+        round_trip(deck.cue_up_with_data(1, 23, 45, (uint8_t)(i % 30)), ACK, sizeof(ACK));
+        round_trip(deck.status_sense(0, 4), STATUS, sizeof(STATUS));
+    }
+    const size_t allocs = n_allocs - before;
+
+    port.close();
+    ::close(sv[1]);
+    if (!ok) {
+        printf("controller round trip failed\n");
+        return false;
+    }
+    return check("controller", allocs, iterations * 3);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t iterations = (argc > 1) ? (size_t)atol(argv[1]) : 1000;
+    bool ok = true;
+    ok &= test_encoder(iterations);
+    ok &= test_controller(iterations);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,340 @@
+// Protocol analyzer of the capture files recorded by CaptureWriter (see Sony9PinRemote/Capture.h).
+//
+// Both directions are decoded into a timeline of commands and replies with their names,
+// arguments, timecodes, status bits, NAK errors, checksum failures and unanswered commands,
+// followed by a per-command summary. The file is memory-mapped and decoded in place
+// without allocation per packet, so a capture of several GB takes a few seconds with -q.
+//
+// Build (ArxContainer, ArxTypeTraits and DebugLog must be in the include path):
+//     g++ -std=c++11 -O2 -I../.. analyzer.cpp -o analyzer
+//
+// Usage:
+//     ./analyzer [-q (summary only)] [-t reply_timeout_ms] capture.s9pc
+
+#include <Sony9PinRemote.h>
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Sony9PinRemote;
+
+namespace {
+
+// =============== Names ===============
+
+// names and timecode flags come from the command table (Sony9PinRemote/Commands.h)
+
+const char* command_label(const uint8_t header, const uint8_t cmd2) {
+    const char* name = command_name(header, cmd2);
+    return name ? name : "UNKNOWN";
+}
+
+const char* reply_label(const uint8_t header, const uint8_t cmd2) {
+    const char* name = reply_name(header, cmd2);
+    return name ? name : "UNKNOWN";
+}
+
+// the data of these packets starts with a BCD timecode
+bool has_timecode(const CaptureDirection dir, const uint8_t header, const uint8_t cmd2) {
+    if ((header & HeaderMask::SIZE) < 4) return false;
+    if (dir == CaptureDirection::RX) return reply_info(header, cmd2).timecode();
+    return command_info(header, cmd2).timecode();
+}
+
+// =============== Output ===============
+
+// fixed line buffer, so nothing is allocated per packet
+struct Line {
+    char buf[1024];
+    size_t n {0};
+
+    void add(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (n >= sizeof(buf)) return;
+        va_list args;
+        va_start(args, fmt);
+        const int r = vsnprintf(buf + n, sizeof(buf) - n, fmt, args);
+        va_end(args);
+        if (r > 0) n += (size_t)r;
+        if (n > sizeof(buf)) n = sizeof(buf);
+    }
+    void flush() {
+        if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+        buf[n++] = '\n';
+        fwrite(buf, 1, n, stdout);
+        n = 0;
+    }
+};
+
+// =============== Analysis ===============
+
+struct CommandStats {
+    uint32_t count {0};
+    uint32_t replies {0};
+    uint32_t naks {0};
+    uint32_t unanswered {0};
+    uint32_t min_us {0xFFFFFFFF};
+    uint32_t max_us {0};
+    uint64_t total_us {0};
+};
+
+struct Pending {
+    bool active {false};
+    uint8_t cmd1 {0};
+    uint8_t cmd2 {0};
+    uint8_t arg {0};  // first data byte (range of STATUS SENSE)
+    uint64_t timestamp_us {0};
+};
+
+class Analyzer {
+    bool quiet;
+    uint64_t timeout_us;
+    uint64_t origin_us {0};
+    bool b_origin {false};
+
+    Pending pending;
+    CommandStats stats[256 * 256];  // (header, cmd2), so the BlackMagic aliases are counted separately
+    size_t n_tx {0}, n_rx {0}, n_unanswered {0}, n_unsolicited {0}, n_late {0}, n_naks {0};
+    size_t n_checksum[2] {0, 0};
+    Line line;
+
+public:
+    Analyzer(const bool q, const uint32_t timeout_ms) : quiet(q), timeout_us((uint64_t)timeout_ms * 1000) {}
+
+    void run(CaptureReader& reader) {
+        Decoder tx, rx;
+        tx.accept_commands(true);
+        tx.enable_resync();
+        rx.enable_resync();
+        CaptureRecord r;
+        while (reader.next(r)) {
+            if (!b_origin) {
+                origin_us = r.timestamp_us;
+                b_origin = true;
+            }
+            Decoder& d = (r.dir == CaptureDirection::TX) ? tx : rx;
+            const size_t lost = d.lost_count();
+            size_t consumed = 0;
+            while (consumed < r.size || d.pending()) {
+                const FeedResult result = d.feed(r.data + consumed, r.size - consumed);
+                consumed += result.consumed;
+                if (result.packets) {
+                    if (r.dir == CaptureDirection::TX)
+                        on_command(d, r.timestamp_us);
+                    else
+                        on_reply(d, r.timestamp_us);
+                }
+            }
+            if (d.lost_count() != lost) on_checksum_error(r.dir, d.lost_count() - lost, r.timestamp_us);
+        }
+        if (pending.active) unanswered();
+        if (reader.truncated() && !quiet) {
+            line.add("-- capture is truncated at offset %zu", reader.offset());
+            line.flush();
+        }
+    }
+
+    void summary() const {
+        printf("\n%-34s %10s %10s %8s %10s %10s %10s %10s\n", "command", "count", "replies", "naks", "unanswered", "min_us", "avg_us", "max_us");
+        for (size_t i = 0; i < 256 * 256; ++i) {
+            const CommandStats& s = stats[i];
+            if (s.count == 0) continue;
+            const uint8_t cmd1 = (uint8_t)(i >> 8);
+            const uint8_t cmd2 = (uint8_t)(i & 0xFF);
+            printf("%02X.%02X %-28s %10u %10u %8u %10u %10u %10u %10u\n", cmd1, cmd2, command_label(cmd1, cmd2),
+                   s.count, s.replies, s.naks, s.unanswered,
+                   s.replies ? s.min_us : 0, s.replies ? (uint32_t)(s.total_us / s.replies) : 0, s.max_us);
+        }
+        printf("\ncommands %zu, replies %zu, NAK %zu, unanswered %zu, late %zu, unsolicited replies %zu, checksum errors TX %zu RX %zu\n",
+               n_tx, n_rx, n_naks, n_unanswered, n_late, n_unsolicited, n_checksum[0], n_checksum[1]);
+    }
+
+private:
+    void on_command(const Decoder& d, const uint64_t ts) {
+        ++n_tx;
+        if (pending.active) unanswered();
+        const uint8_t cmd1 = (uint8_t)d.cmd1() | d.size();
+        const uint8_t cmd2 = d.cmd2();
+        ++stats_of(cmd1, cmd2).count;
+        pending.active = true;
+        pending.cmd1 = cmd1;
+        pending.cmd2 = cmd2;
+        pending.arg = d.size() ? d.data()[0] : 0;
+        pending.timestamp_us = ts;
+        if (quiet) return;
+
+        begin(ts, CaptureDirection::TX, cmd1, cmd2, command_label(cmd1, cmd2));
+        if (has_timecode(CaptureDirection::TX, cmd1, cmd2))
+            add_timecode(d.timecode());
+        else
+            add_bytes(d);
+        line.flush();
+    }
+
+    void on_reply(const Decoder& d, const uint64_t ts) {
+        ++n_rx;
+        const uint8_t cmd1 = (uint8_t)d.cmd1() | d.size();
+        const uint8_t cmd2 = d.cmd2();
+        const bool is_nak = d.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && cmd2 == SystemControlReturn::NAK;
+        if (is_nak) ++n_naks;
+
+        uint64_t latency = 0;
+        const bool answered = pending.active;
+        if (answered) {
+            latency = ts - pending.timestamp_us;
+            CommandStats& s = stats_of(pending.cmd1, pending.cmd2);
+            ++s.replies;
+            if (is_nak) ++s.naks;
+            const uint32_t us = (latency > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)latency;
+            if (us < s.min_us) s.min_us = us;
+            if (us > s.max_us) s.max_us = us;
+            s.total_us += us;
+            if (latency > timeout_us) ++n_late;
+        } else {
+            ++n_unsolicited;
+        }
+        if (quiet) {
+            pending.active = false;
+            return;
+        }
+
+        begin(ts, CaptureDirection::RX, cmd1, cmd2, reply_label(cmd1, cmd2));
+        if (answered)
+            line.add(" (+%llu us%s)", (unsigned long long)latency, (latency > timeout_us) ? ", LATE" : "");
+        else
+            line.add(" (UNSOLICITED)");
+
+        if (is_nak)
+            add_nak(d.nak());
+        else if (d.cmd1() == Cmd1::SYSTEM_CONTROL_RETURN && cmd2 == SystemControlReturn::DEVICE_TYPE)
+            line.add(" %04X", d.device_type());
+        else if (d.cmd1() == Cmd1::SENSE_RETURN && cmd2 == SenseReturn::STATUS_DATA)
+            add_status(d);
+        else if (has_timecode(CaptureDirection::RX, cmd1, cmd2))
+            add_timecode(d.timecode());
+        else
+            add_bytes(d);
+        line.flush();
+        pending.active = false;
+    }
+
+    void on_checksum_error(const CaptureDirection dir, const size_t n, const uint64_t ts) {
+        n_checksum[(size_t)dir] += n;
+        if (quiet) return;
+        add_time(ts);
+        line.add(" %s !! checksum error (%zu packet%s dropped)", dir_name(dir), n, (n > 1) ? "s" : "");
+        line.flush();
+    }
+
+    void unanswered() {
+        ++n_unanswered;
+        ++stats_of(pending.cmd1, pending.cmd2).unanswered;
+        pending.active = false;
+        if (quiet) return;
+        add_time(pending.timestamp_us);
+        line.add(" TX !! %02X.%02X %s UNANSWERED", pending.cmd1, pending.cmd2, command_label(pending.cmd1, pending.cmd2));
+        line.flush();
+    }
+
+    CommandStats& stats_of(const uint8_t cmd1, const uint8_t cmd2) { return stats[((size_t)cmd1 << 8) | cmd2]; }
+
+    // "seconds.microseconds" from the first record (integer formatting is much faster than %f)
+    void add_time(const uint64_t ts) {
+        const uint64_t us = ts - origin_us;
+        line.add("%7llu.%06llu", (unsigned long long)(us / 1000000), (unsigned long long)(us % 1000000));
+    }
+
+    static const char* dir_name(const CaptureDirection dir) { return (dir == CaptureDirection::TX) ? "TX" : "RX"; }
+
+    void begin(const uint64_t ts, const CaptureDirection dir, const uint8_t cmd1, const uint8_t cmd2, const char* name) {
+        add_time(ts);
+        line.add(" %s %02X.%02X %s", dir_name(dir), cmd1, cmd2, name);
+    }
+
+    void add_bytes(const Decoder& d) {
+        for (uint8_t i = 0; i < d.size(); ++i) line.add(" %02X", d.data()[i]);
+    }
+
+    void add_timecode(const TimeCode& tc) {
+        line.add(" %02u:%02u:%02u%c%02u%s", tc.hour, tc.minute, tc.second, tc.is_df ? ';' : ':', tc.frame, tc.is_cf ? " CF" : "");
+    }
+
+    void add_nak(const Errors& e) {
+        if (e.b_unknown_cmd) line.add(" UNKNOWN_CMD");
+        if (e.b_checksum_error) line.add(" CHECKSUM_ERROR");
+        if (e.b_parity_error) line.add(" PARITY_ERROR");
+        if (e.b_buffer_overrun) line.add(" BUFFER_OVERRUN");
+        if (e.b_framing_error) line.add(" FRAMING_ERROR");
+        if (e.b_timeout) line.add(" TIMEOUT");
+    }
+
+    // bits set in the range requested by the STATUS SENSE
+    void add_status(const Decoder& d) {
+        const bool requested = pending.active && ((Cmd1)(pending.cmd1 & (uint8_t)HeaderMask::CMD1) == Cmd1::SENSE_REQUEST)
+                            && pending.cmd2 == SenseRequest::STATUS_SENSE;
+        const uint8_t start = requested ? (pending.arg >> 4) : 0;
+        const uint8_t size = requested ? (pending.arg & 0x0F) : d.size();
+        const RawStatus sts = d.raw_status_sense(start, size);
+#define SONY9PIN_STATUS_NAME(byte, mask, name) \
+    if (byte >= start && byte < start + size && sts.name()) line.add(" " #mask);
+        SONY9PIN_STATUS_BITS(SONY9PIN_STATUS_NAME)
+#undef SONY9PIN_STATUS_NAME
+    }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bool quiet = false;
+    uint32_t timeout_ms = 100;
+    int c;
+    while ((c = getopt(argc, argv, "qt:")) != -1) {
+        switch (c) {
+            case 'q': quiet = true; break;
+            case 't': timeout_ms = strtoul(optarg, nullptr, 10); break;
+            default:
+                fprintf(stderr, "usage: %s [-q] [-t reply_timeout_ms] capture.s9pc\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-q] [-t reply_timeout_ms] capture.s9pc\n", argv[0]);
+        return 1;
+    }
+
+    const int fd = ::open(argv[optind], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    const size_t size = (size_t)st.st_size;
+    void* map = size ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    if (size && map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    if (size) ::madvise(map, size, MADV_SEQUENTIAL);
+
+    CaptureReader reader((const uint8_t*)map, size);
+    if (!reader.valid()) {
+        fprintf(stderr, "%s is not a capture file\n", argv[optind]);
+        return 1;
+    }
+
+    static char out[1 << 20];
+    setvbuf(stdout, out, _IOFBF, sizeof(out));
+
+    static Analyzer analyzer(quiet, timeout_ms);  // the stats table is large for the stack
+    analyzer.run(reader);
+    analyzer.summary();
+
+    if (size) ::munmap(map, size);
+    ::close(fd);
+    return 0;
+}
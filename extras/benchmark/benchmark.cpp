@@ -0,0 +1,288 @@
+// Host microbenchmarks of Encoder, Decoder and Controller.
+// The results are printed as JSON to track regressions between releases.
+//
+// Build (ArxContainer, ArxTypeTraits and DebugLog must be in the include path):
+//     g++ -std=c++11 -O2 -I../.. benchmark.cpp -o benchmark
+//
+// Usage:
+//     ./benchmark [min_time_ms] > result.json
+
+#include <Sony9PinRemote.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace Sony9PinRemote;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// keep the value alive so that the compiler does not drop the benchmarked code
+template <typename T>
+inline void do_not_optimize(const T& v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+// hide the value from the compiler so that the code using it cannot be constant-folded
+template <typename T>
+inline T opaque(T v) {
+    asm volatile("" : "+m"(v));
+    return v;
+}
+
+struct Result {
+    const char* name;
+    uint64_t iterations;
+    double ns_per_op;
+    double bytes_per_op;
+    double packets_per_op;
+};
+
+std::vector<Result> results;
+double min_time_ms = 200.0;
+
+// Run `f` in batches until `min_time_ms` has passed.
+// `f` returns the number of operations done in one call.
+template <typename F>
+void bench(const char* name, F&& f, const double bytes_per_op = 0.0, const double packets_per_op = 0.0) {
+    for (int i = 0; i < 1000; ++i) f();  // warm up
+
+    uint64_t ops = 0;
+    uint64_t batch = 1000;
+    const Clock::time_point begin = Clock::now();
+    double elapsed_ns = 0.0;
+    while (true) {
+        for (uint64_t i = 0; i < batch; ++i) ops += f();
+        elapsed_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+        if (elapsed_ns >= min_time_ms * 1e6) break;
+        batch *= 2;
+    }
+    results.push_back({name, ops, elapsed_ns / (double)ops, bytes_per_op, packets_per_op});
+}
+
+// reply packet with checksum
+std::vector<uint8_t> make_reply(const uint8_t cmd1, const uint8_t cmd2, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> p;
+    p.push_back(cmd1 | (uint8_t)data.size());
+    p.push_back(cmd2);
+    p.insert(p.end(), data.begin(), data.end());
+    uint8_t crc = 0;
+    for (const uint8_t b : p) crc += b;
+    p.push_back(crc);
+    return p;
+}
+
+const std::vector<uint8_t> ACK = make_reply(0x10, 0x01, {});
+const std::vector<uint8_t> STATUS = make_reply(0x70, 0x20, {0x00, 0x81, 0x80, 0x03, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00});
+const std::vector<uint8_t> STATUS_PARTIAL = make_reply(0x70, 0x20, {0x81, 0x80, 0x03});
+const std::vector<uint8_t> LTC_TC_UB = make_reply(0x70, 0x04, {0x12, 0x34, 0x56, 0x01, 0x11, 0x22, 0x33, 0x44});
+
+Decoder decoded(const std::vector<uint8_t>& packet) {
+    Decoder d;
+    d.feed(packet.data(), packet.size());
+    return d;
+}
+
+// =============== Encoder ===============
+
+// Every input (including the Encoder and the method itself, through a function pointer) is passed
+// through `opaque()`, so the packets cannot be constant-folded at compile time.
+void bench_encoder() {
+    using Encode = Encoder::Packet (*)(Encoder&);
+    Encoder encoder;
+    const Encode stop = opaque<Encode>([](Encoder& e) { return e.stop(); });
+    bench("encoder/parameterless/stop", [&] {
+        auto p = opaque(stop)(*opaque(&encoder));
+        do_not_optimize(p);
+        return 1;
+    });
+    bench("encoder/parameterless/status_sense", [&] {
+        auto p = opaque(&encoder)->status_sense(opaque<uint8_t>(0), opaque<uint8_t>(10));
+        do_not_optimize(p);
+        return 1;
+    });
+    uint8_t frame = 0;
+    bench("encoder/bcd_timecode/cue_up_with_data", [&] {
+        auto p = opaque(&encoder)->cue_up_with_data(opaque(TimeCode::hmsf(1, 23, 45, frame++ % 30)));
+        do_not_optimize(p);
+        return 1;
+    });
+    bench("encoder/bcd_timecode/in_data_preset", [&] {
+        auto p = opaque(&encoder)->in_data_preset(opaque<uint8_t>(1), opaque<uint8_t>(23), opaque<uint8_t>(45), opaque<uint8_t>(frame++ % 30));
+        do_not_optimize(p);
+        return 1;
+    });
+    uint8_t speed = 0;
+    bench("encoder/variadic/jog_forward", [&] {
+        auto p = opaque(&encoder)->jog_forward(opaque<uint8_t>(speed++), opaque<uint8_t>(0));
+        do_not_optimize(p);
+        return 1;
+    });
+    bench("encoder/variadic/user_bit_preset", [&] {
+        auto p = opaque(&encoder)->user_bit_preset(opaque<uint8_t>(speed++), opaque<uint8_t>(0x22), opaque<uint8_t>(0x33), opaque<uint8_t>(0x44));
+        do_not_optimize(p);
+        return 1;
+    });
+    // baseline: copy of a packet encoded at compile time
+    bench("encoder/prebuilt/stop", [&] {
+        uint8_t p[prebuilt::stop::size];
+        memcpy(p, opaque(prebuilt::stop::data), sizeof(p));
+        do_not_optimize(p);
+        return 1;
+    });
+}
+
+// =============== Decoder ===============
+
+void bench_decoder() {
+    // stream of mixed replies
+    std::vector<uint8_t> stream;
+    size_t n_packets = 0;
+    while (stream.size() < 4096) {
+        for (const auto* p : {&ACK, &STATUS, &LTC_TC_UB}) {
+            stream.insert(stream.end(), p->begin(), p->end());
+            ++n_packets;
+        }
+    }
+    const double bytes = (double)stream.size();
+    const double packets = (double)n_packets;
+
+    Decoder decoder;
+    bench("decoder/feed/byte", [&] {
+        for (const uint8_t b : stream) do_not_optimize(decoder.feed(b));
+        return 1;
+    }, bytes, packets);
+    bench("decoder/feed/bulk", [&] {
+        const FeedResult r = decoder.feed(stream.data(), stream.size(), false);
+        do_not_optimize(r);
+        return 1;
+    }, bytes, packets);
+    decoder.enable_resync();
+    bench("decoder/feed/bulk_resync", [&] {
+        const FeedResult r = decoder.feed(stream.data(), stream.size(), false);
+        do_not_optimize(r);
+        return 1;
+    }, bytes, packets);
+
+    const Decoder full = decoded(STATUS);
+    bench("decoder/status_sense/full", [&] {
+        const Status s = full.status_sense();
+        do_not_optimize(s);
+        return 1;
+    });
+    bench("decoder/raw_status_sense/full", [&] {
+        const RawStatus s = full.raw_status_sense();
+        do_not_optimize(s);
+        return 1;
+    });
+    const Decoder partial = decoded(STATUS_PARTIAL);
+    bench("decoder/status_sense/partial_1_3", [&] {
+        const Status s = partial.status_sense(1, 3);
+        do_not_optimize(s);
+        return 1;
+    });
+
+    const Decoder tcub = decoded(LTC_TC_UB);
+    bench("decoder/timecode", [&] {
+        const TimeCode tc = tcub.timecode();
+        do_not_optimize(tc);
+        return 1;
+    });
+    bench("decoder/userbits", [&] {
+        const UserBits ub = tcub.userbits();
+        do_not_optimize(ub);
+        return 1;
+    });
+    bench("decoder/ltc_tc_ub", [&] {
+        const TimeCodeAndUserBits v = tcub.ltc_tc_ub();
+        do_not_optimize(v);
+        return 1;
+    });
+}
+
+// =============== TimeCode ===============
+
+void bench_timecode() {
+    uint32_t f = 0;
+    bench("timecode/from_frames/29.97df", [&] {
+        const TimeCode tc = timecode::from_frames(f++, FrameRate::FPS_29_97, true);
+        do_not_optimize(tc);
+        return 1;
+    });
+    bench("timecode/to_frames/29.97df", [&] {
+        const uint32_t v = timecode::to_frames(TimeCode::hmsf(1, (uint8_t)(f++ % 60), 30, 15, false, true), FrameRate::FPS_29_97);
+        do_not_optimize(v);
+        return 1;
+    });
+}
+
+// =============== Controller ===============
+
+// Replies are written to one end of a socket pair and parsed by the Controller on the other end,
+// so this includes the syscalls of the receive path (FIONREAD + read) as on a real port.
+void bench_controller() {
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+        perror("socketpair");
+        return;
+    }
+    PosixSerial port;
+    port.attach(sv[0], false);
+    Controller deck;
+    deck.attach(port, true);  // force_send: replies are not correlated with the commands
+
+    std::vector<uint8_t> burst;
+    size_t n_packets = 0;
+    while (burst.size() < 512) {
+        for (const auto* p : {&ACK, &STATUS, &LTC_TC_UB}) {
+            burst.insert(burst.end(), p->begin(), p->end());
+            ++n_packets;
+        }
+    }
+
+    bench("controller/parse/burst", [&] {
+        if (::write(sv[1], burst.data(), burst.size()) < 0) abort();
+        size_t n = 0;
+        while (n < n_packets)
+            if (deck.parse()) ++n;
+        StatusEvent e;
+        while (deck.next_status_event(e)) {
+        }
+        return 1;
+    }, (double)burst.size(), (double)n_packets);
+
+    ::close(sv[1]);
+    port.close();
+    ::close(sv[0]);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) min_time_ms = atof(argv[1]);
+
+    bench_encoder();
+    bench_decoder();
+    bench_timecode();
+    bench_controller();
+
+    printf("{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        printf("    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.2f", r.name, (unsigned long long)r.iterations, r.ns_per_op);
+        if (r.bytes_per_op > 0.0)
+            printf(", \"bytes_per_sec\": %.0f", r.bytes_per_op * 1e9 / r.ns_per_op);
+        if (r.packets_per_op > 0.0)
+            printf(", \"packets_per_sec\": %.0f", r.packets_per_op * 1e9 / r.ns_per_op);
+        printf("}%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Many decks serviced by one thread with DeckManager (Linux only).
+//
+// N pty pairs are opened. One responder thread runs a VirtualDeck on the master side of each pair,
+// and the Controllers on the slave sides are driven by a single DeckManager.
+// Every deck polls status / timecode as fast as the replies come back (or once per frame
+// with -f), and the replies per second and the round-trip latency of all decks are printed as JSON.
+//
+// Build (ArxContainer, ArxTypeTraits and DebugLog must be in the include path):
+//     g++ -std=c++11 -O2 -I../.. deck_manager.cpp -o deck_manager -lutil -lpthread
+//
+// Usage:
+//     ./deck_manager [-n decks] [-s seconds] [-f (pace at 29.97 fps)] [-d (one deck never replies)]
+
+#include <Sony9PinRemote.h>
+#include <Sony9PinRemote/DeckManager.h>
+#include <Sony9PinRemote/VirtualDeck.h>
+
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Sony9PinRemote;
+
+namespace {
+
+struct Options {
+    size_t decks {64};
+    uint32_t seconds {2};
+    bool paced {false};
+    bool dead_deck {false};
+};
+
+Options parse_options(int argc, char** argv) {
+    Options opt;
+    int c;
+    while ((c = getopt(argc, argv, "n:s:fd")) != -1) {
+        switch (c) {
+            case 'n': opt.decks = strtoul(optarg, nullptr, 10); break;
+            case 's': opt.seconds = strtoul(optarg, nullptr, 10); break;
+            case 'f': opt.paced = true; break;
+            case 'd': opt.dead_deck = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n decks] [-s seconds] [-f] [-d]\n", argv[0]);
+                exit(1);
+        }
+    }
+    if (opt.decks == 0 || opt.decks > 256) opt.decks = 64;
+    return opt;
+}
+
+// device side of every pty pair in one epoll loop (the first one is muted with -d)
+void respond(const std::vector<int>& fds, const bool mute_first, std::atomic<bool>& running) {
+    const int ep = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<VirtualDeck> decks(fds.size(), VirtualDeck(FrameRate::FPS_29_97));
+    for (size_t i = 0; i < fds.size(); ++i) {
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+        ::epoll_ctl(ep, EPOLL_CTL_ADD, fds[i], &ev);
+    }
+    uint8_t buf[256];
+    epoll_event events[64];
+    while (running.load(std::memory_order_relaxed)) {
+        const int n = ::epoll_wait(ep, events, 64, 10);
+        for (int k = 0; k < n; ++k) {
+            const size_t i = events[k].data.u32;
+            const ssize_t m = ::read(fds[i], buf, sizeof(buf));
+            if (m <= 0 || (mute_first && i == 0)) continue;
+            decks[i].update(SteadyClock::micros());
+            decks[i].feed(buf, (size_t)m);
+            const size_t r = decks[i].read(buf, sizeof(buf));
+            if (r > 0 && ::write(fds[i], buf, r) < 0) break;
+        }
+    }
+    ::close(ep);
+}
+
+struct Context {
+    size_t replies {0};
+    size_t restarts {0};
+};
+
+// keep every deck busy: send the next request as soon as the previous one completes
+void on_reply(const size_t, Controller& deck, void* context) {
+    Context* ctx = (Context*)context;
+    ++ctx->replies;
+    if (deck.queued() == 0) {
+        if (ctx->replies & 1)
+            deck.status_sense();
+        else
+            deck.current_time_sense_ltc_tc();
+    }
+}
+
+// restart the deck whose command has timed out (-d); the manager schedules it after the handler
+void on_timeout(const size_t, Controller& deck, void* context) {
+    Context* ctx = (Context*)context;
+    ++ctx->restarts;
+    if (deck.queued() == 0) deck.status_sense();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const Options opt = parse_options(argc, argv);
+
+    std::vector<int> masters(opt.decks), slaves(opt.decks);
+    std::vector<PosixSerial> master_ports(opt.decks), ports(opt.decks);
+    std::vector<Controller> decks(opt.decks);
+    DeckManager<256> manager;
+    Context ctx;
+    manager.set_reply_handler(on_reply, &ctx);
+    manager.set_timeout_handler(on_timeout, &ctx);
+
+    for (size_t i = 0; i < opt.decks; ++i) {
+        if (::openpty(&masters[i], &slaves[i], nullptr, nullptr, nullptr) != 0) {
+            perror("openpty");
+            return 1;
+        }
+        if (!ports[i].attach(slaves[i])) {
+            perror("attach");
+            return 1;
+        }
+        // the master side is raw too, otherwise the line discipline rewrites the bytes
+        master_ports[i].attach(masters[i]);
+        decks[i].attach(ports[i]);
+        decks[i].set_reply_timeout(50);
+        if (opt.paced) decks[i].set_frame_rate(FrameRate::FPS_29_97);
+        if (manager.add(decks[i], ports[i]) < 0) {
+            fprintf(stderr, "failed to add deck %zu\n", i);
+            return 1;
+        }
+    }
+
+    std::atomic<bool> running {true};
+    std::thread responder(respond, std::cref(masters), opt.dead_deck, std::ref(running));
+
+    for (size_t i = 0; i < opt.decks; ++i) {
+        decks[i].status_sense();
+        manager.schedule(i);
+    }
+
+    clock_t cpu_begin = clock();
+    const uint32_t begin_us = SteadyClock::micros();
+    size_t wakeups = 0;
+    while (SteadyClock::micros() - begin_us < opt.seconds * 1000000) {
+        manager.poll(100);
+        ++wakeups;
+    }
+    const uint32_t elapsed_us = SteadyClock::micros() - begin_us;
+    const double cpu_sec = (double)(clock() - cpu_begin) / CLOCKS_PER_SEC;
+
+    running = false;
+    responder.join();
+
+    uint32_t p99_max = 0;
+    uint32_t timeouts = 0;
+    for (size_t i = 0; i < opt.decks; ++i) {
+        for (size_t k = 0; k < decks[i].latency_size(); ++k) {
+            const LatencySnapshot s = decks[i].latency(k);
+            if (s.p99_us > p99_max) p99_max = s.p99_us;
+            timeouts += s.timeouts;
+        }
+    }
+
+    printf("{\n");
+    printf("  \"decks\": %zu,\n", opt.decks);
+    printf("  \"paced\": %s,\n", opt.paced ? "true" : "false");
+    printf("  \"elapsed_us\": %u,\n", elapsed_us);
+    printf("  \"replies\": %zu,\n", ctx.replies);
+    printf("  \"replies_per_sec\": %.1f,\n", elapsed_us ? (double)ctx.replies * 1e6 / elapsed_us : 0.0);
+    printf("  \"timeouts\": %u,\n", timeouts);
+    printf("  \"restarts\": %zu,\n", ctx.restarts);
+    printf("  \"max_p99_rtt_us\": %u,\n", p99_max);
+    printf("  \"poll_calls\": %zu,\n", wakeups);
+    printf("  \"cpu_sec\": %.3f\n", cpu_sec);
+    printf("}\n");
+
+    for (size_t i = 0; i < opt.decks; ++i) {
+        ::close(masters[i]);
+        ::close(slaves[i]);
+    }
+    return 0;
+}
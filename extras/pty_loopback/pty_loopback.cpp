@@ -0,0 +1,203 @@
+// End-to-end loopback benchmark of the Linux / macOS I/O path.
+//
+// A pseudo-terminal pair is opened. A responder thread runs VirtualDeck on the master side,
+// and a Controller is attached to the slave side through PosixSerial::attach().
+// Each command is sent after the reply of the previous one has been parsed by `parse_until()`
+// (which sleeps in PosixSerial::wait()), and the round-trip latency is measured.
+// The syscalls made per command are counted on both ends. The result is printed as JSON.
+//
+// Build (ArxContainer, ArxTypeTraits and DebugLog must be in the include path):
+//     g++ -std=c++11 -O2 -I../.. pty_loopback.cpp -o pty_loopback -lutil -lpthread
+//
+// Usage:
+//     ./pty_loopback [-n commands] [-w warmup] [-t timeout_ms]
+
+#include <Sony9PinRemote.h>
+#include <Sony9PinRemote/VirtualDeck.h>
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Sony9PinRemote;
+
+namespace {
+
+struct Options {
+    size_t commands {2000};
+    size_t warmup {100};
+    uint32_t timeout_ms {1000};
+};
+
+Options parse_options(int argc, char** argv) {
+    Options opt;
+    int c;
+    while ((c = getopt(argc, argv, "n:w:t:")) != -1) {
+        switch (c) {
+            case 'n': opt.commands = strtoul(optarg, nullptr, 10); break;
+            case 'w': opt.warmup = strtoul(optarg, nullptr, 10); break;
+            case 't': opt.timeout_ms = strtoul(optarg, nullptr, 10); break;
+            default:
+                fprintf(stderr, "usage: %s [-n commands] [-w warmup] [-t timeout_ms]\n", argv[0]);
+                exit(1);
+        }
+    }
+    return opt;
+}
+
+// device side: wait for bytes from the controller and write the replies back
+// (the syscalls are counted only for the wakeups by a command, not for the idle timeouts)
+void respond(PosixSerial& port, std::atomic<bool>& running, std::atomic<size_t>& syscalls) {
+    VirtualDeck deck(FrameRate::FPS_29_97);
+    uint8_t buf[256];
+    while (running.load(std::memory_order_relaxed)) {
+        const size_t before = port.syscall_count();
+        if (!port.wait(10000)) continue;
+        const size_t n = port.read(buf, sizeof(buf));
+        if (n > 0) {
+            deck.update(SteadyClock::micros());
+            deck.feed(buf, n);
+            const size_t m = deck.read(buf, sizeof(buf));
+            if (m > 0 && port.write(buf, m) != m) break;
+        }
+        syscalls += port.syscall_count() - before;
+    }
+}
+
+// controller side: send one command and block in poll() until its record is completed
+CommandId send_command(Controller& deck, const size_t i) {
+    switch (i % 4) {
+        case 0: return deck.status_sense();
+        case 1: return deck.current_time_sense_ltc_tc();
+        case 2: return deck.play();
+        default: return deck.stop();
+    }
+}
+
+// the library's own wait path: parse_until() sleeps in PosixSerial::wait() until the reply arrives
+bool wait_for(Controller& deck, const CommandId id, const uint32_t timeout_ms) {
+    const uint32_t begin_us = SteadyClock::micros();
+    while (true) {
+        const CommandRecord* r = deck.command(id);
+        if (!r) return false;
+        if (r->completed()) return r->status != CommandStatus::TIMEOUT;
+        const uint32_t elapsed_ms = (SteadyClock::micros() - begin_us) / 1000;
+        if (elapsed_ms > timeout_ms) return false;
+        deck.parse_until(timeout_ms - elapsed_ms + 1);
+    }
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, const double p) {
+    if (sorted.empty()) return 0;
+    const size_t idx = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+    return sorted[idx];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const Options opt = parse_options(argc, argv);
+
+    int master = -1, slave = -1;
+    if (::openpty(&master, &slave, nullptr, nullptr, nullptr) != 0) {
+        perror("openpty");
+        return 1;
+    }
+
+    PosixSerial port;
+    if (!port.attach(slave)) {
+        perror("attach");
+        return 1;
+    }
+    // the master side is raw too, otherwise the line discipline rewrites the bytes
+    // (some kernels refuse to configure the master, then it is used as it is)
+    PosixSerial master_port;
+    if (!master_port.attach(master) && !master_port.attach(master, false)) {
+        perror("attach master");
+        return 1;
+    }
+
+    Controller deck;
+    deck.attach(port);
+    deck.set_reply_timeout(opt.timeout_ms);
+
+    std::atomic<bool> running {true};
+    std::atomic<size_t> responder_syscalls {0};
+    std::thread responder(respond, std::ref(master_port), std::ref(running), std::ref(responder_syscalls));
+
+    std::vector<uint32_t> rtt;
+    rtt.reserve(opt.commands);
+    size_t failed = 0;
+    uint32_t begin_us = 0;
+
+    for (size_t i = 0; i < opt.warmup + opt.commands; ++i) {
+        if (i == opt.warmup) {
+            // the warmup is excluded from the histograms and the syscall counts too
+            deck.reset_latency();
+            deck.reset_queue_delay();
+            port.reset_syscall_count();
+            responder_syscalls = 0;
+            begin_us = SteadyClock::micros();
+        }
+        const uint32_t t0 = SteadyClock::micros();
+        const CommandId id = send_command(deck, i);
+        const bool ok = wait_for(deck, id, opt.timeout_ms);
+        const uint32_t t1 = SteadyClock::micros();
+        if (i < opt.warmup) continue;
+        if (ok)
+            rtt.push_back(t1 - t0);
+        else
+            ++failed;
+    }
+    const uint32_t elapsed_us = SteadyClock::micros() - begin_us;
+    const size_t controller_syscalls = port.syscall_count();
+
+    running = false;
+    responder.join();
+    ::close(master);
+    ::close(slave);
+
+    std::sort(rtt.begin(), rtt.end());
+    uint64_t total = 0;
+    for (const uint32_t v : rtt) total += v;
+
+    printf("{\n");
+    printf("  \"commands\": %zu,\n", opt.commands);
+    printf("  \"completed\": %zu,\n", rtt.size());
+    printf("  \"failed\": %zu,\n", failed);
+    printf("  \"elapsed_us\": %u,\n", elapsed_us);
+    printf("  \"commands_per_sec\": %.1f,\n", elapsed_us ? (double)rtt.size() * 1e6 / elapsed_us : 0.0);
+    printf("  \"controller_syscalls_per_command\": %.2f,\n", opt.commands ? (double)controller_syscalls / opt.commands : 0.0);
+    printf("  \"responder_syscalls_per_command\": %.2f,\n", opt.commands ? (double)responder_syscalls.load() / opt.commands : 0.0);
+    printf("  \"rtt_us\": {\n");
+    printf("    \"min\": %u,\n", rtt.empty() ? 0 : rtt.front());
+    printf("    \"mean\": %.1f,\n", rtt.empty() ? 0.0 : (double)total / rtt.size());
+    printf("    \"p50\": %u,\n", percentile(rtt, 0.50));
+    printf("    \"p90\": %u,\n", percentile(rtt, 0.90));
+    printf("    \"p99\": %u,\n", percentile(rtt, 0.99));
+    printf("    \"max\": %u\n", rtt.empty() ? 0 : rtt.back());
+    printf("  },\n");
+    // histograms recorded by the Controller itself (write to reply, without the poll wakeup of this loop)
+    printf("  \"per_command_us\": [\n");
+    for (size_t i = 0; i < deck.latency_size(); ++i) {
+        const LatencySnapshot s = deck.latency(i);
+        printf("    {\"cmd1\": %u, \"cmd2\": %u, \"count\": %u, \"timeouts\": %u, \"min\": %u, \"p50\": %u, \"p99\": %u, \"max\": %u}%s\n",
+               (unsigned)s.cmd1, (unsigned)s.cmd2, s.count, s.timeouts, s.min_us, s.p50_us, s.p99_us, s.max_us,
+               (i + 1 < deck.latency_size()) ? "," : "");
+    }
+    printf("  ]\n");
+    printf("}\n");
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,169 @@
+// Host test of the TimeCode arithmetic (Sony9PinRemote/TimeCode.h).
+// Every frame of a day is converted to the label and back at every rate (DF and NDF),
+// the DF labels around the minute and ten-minute boundaries are checked,
+// the labels with out-of-range fields (hours >= 24 etc.) are compared with plain division,
+// and every label is encoded to the BCD time data format and decoded back.
+// Exits with 1 if anything differs.
+//
+// Build (ArxContainer, ArxTypeTraits and DebugLog must be in the include path):
+//     g++ -std=c++11 -O2 -I../.. timecode_test.cpp -o timecode_test
+// Add -DSONY9PINREMOTE_TIMECODE_BINARY_DIVISION=1 to test the division-free path used on AVR.
+//
+// Usage:
+//     ./timecode_test
+
+#include <Sony9PinRemote.h>
+
+#include <stdio.h>
+
+using namespace Sony9PinRemote;
+
+// the constructor keeps the member order of the aggregate init (frame first), hmsf() takes the hour first
+static_assert(TimeCode {0, 0, 0, 1}.hour == 1 && TimeCode {0, 0, 0, 1}.frame == 0, "TimeCode constructor is not in member order");
+// the arithmetic is usable in constant expressions
+static_assert(timecode::to_frames(TimeCode::hmsf(1, 0, 0, 0, false, true), FrameRate::FPS_29_97) == 107892, "to_frames is not constexpr");
+static_assert(timecode::from_frames(107892, FrameRate::FPS_29_97, true).hour == 1, "from_frames is not constexpr");
+static_assert(TimeCode::hmsf(1, 2, 3, 4, false, true).hour == 1 && TimeCode::hmsf(1, 2, 3, 4, false, true).frame == 4, "TimeCode::hmsf() is not hour first");
+// the flags are in the member order (CF, DF) in both
+static_assert(TimeCode {0, 0, 0, 1, true, false}.is_cf && !TimeCode {0, 0, 0, 1, true, false}.is_df, "TimeCode constructor flags are not CF, DF");
+static_assert(TimeCode::hmsf(1, 0, 0, 0, true, false).is_cf && !TimeCode::hmsf(1, 0, 0, 0, true, false).is_df, "TimeCode::hmsf() flags are not CF, DF");
+
+namespace {
+
+size_t n_checks {0};
+size_t n_failures {0};
+
+bool same(const TimeCode& a, const TimeCode& b) {
+    return a.hour == b.hour && a.minute == b.minute && a.second == b.second && a.frame == b.frame && a.is_df == b.is_df;
+}
+
+void print(const char* label, const TimeCode& tc) {
+    printf("%s%02u:%02u:%02u%c%02u", label, tc.hour, tc.minute, tc.second, tc.is_df ? ';' : ':', tc.frame);
+}
+
+void expect_frames(const char* name, const TimeCode& tc, const FrameRate fps, const uint32_t expected) {
+    ++n_checks;
+    const uint32_t actual = timecode::to_frames(tc, fps);
+    if (actual == expected) return;
+    ++n_failures;
+    printf("FAIL %s", name);
+    print(" ", tc);
+    printf(" -> %u (expected %u)\n", actual, expected);
+}
+
+void expect_tc(const char* name, const TimeCode& actual, const TimeCode& expected) {
+    ++n_checks;
+    if (same(actual, expected)) return;
+    ++n_failures;
+    printf("FAIL %s", name);
+    print(" ", actual);
+    print(" (expected ", expected);
+    printf(")\n");
+}
+
+// frame count by division (the library uses binary subtraction only)
+uint32_t reference_frames(const TimeCode& tc, const FrameRate fps) {
+    const uint32_t minutes = (uint32_t)tc.hour * 60 + tc.minute;
+    const uint32_t frames = (minutes * 60 + tc.second) * timecode::nominal_fps(fps) + tc.frame;
+    return frames - timecode::drop_frames(fps, tc.is_df) * (minutes - minutes / 10);
+}
+
+const FrameRate RATES[] {
+    FrameRate::FPS_23_976, FrameRate::FPS_24, FrameRate::FPS_25, FrameRate::FPS_29_97,
+    FrameRate::FPS_30, FrameRate::FPS_50, FrameRate::FPS_59_94, FrameRate::FPS_60,
+};
+
+// frame count -> label -> frame count for every frame of a day
+void test_round_trip() {
+    for (const FrameRate fps : RATES) {
+        for (int df = 0; df < 2; ++df) {
+            if (df && !timecode::is_drop_frame_rate(fps)) continue;
+            const uint32_t fpd = timecode::frames_per_day(fps, df);
+            size_t failures = 0;
+            for (uint32_t f = 0; f < fpd; ++f) {
+                const TimeCode tc = timecode::from_frames(f, fps, df);
+                if (!timecode::is_valid(tc, fps) || timecode::to_frames(tc, fps) != f || reference_frames(tc, fps) != f) {
+                    if (failures++ == 0) {
+                        printf("FAIL round trip %u fps%s: frame %u", timecode::nominal_fps(fps), df ? " DF" : "", f);
+                        print(" -> ", tc);
+                        printf("\n");
+                    }
+                }
+            }
+            n_checks += fpd;
+            n_failures += failures;
+        }
+    }
+}
+
+// the labels around the minute and ten-minute boundaries
+void test_df_boundaries() {
+    const FrameRate rates[] {FrameRate::FPS_29_97, FrameRate::FPS_59_94};
+    for (const FrameRate fps : rates) {
+        const uint8_t last = timecode::nominal_fps(fps) - 1;
+        const uint8_t drop = timecode::drop_frames(fps);
+        for (uint8_t hh = 0; hh < 24; hh += 23) {
+            for (uint8_t mm = 0; mm < 60; ++mm) {
+                const TimeCode before = TimeCode::hmsf(hh, mm, 59, last, false, true);
+                const uint8_t next_mm = (mm + 1) % 60;
+                const uint8_t next_hh = (mm == 59) ? (hh + 1) % 24 : hh;
+                const bool tenth = (next_mm % 10) == 0;
+                const TimeCode after = TimeCode::hmsf(next_hh, next_mm, 0, tenth ? 0 : drop, false, true);
+                expect_tc("next label", timecode::add(before, 1, fps), after);
+                expect_tc("previous label", timecode::sub(after, 1, fps), before);
+                expect_frames("boundary", after, fps, reference_frames(after, fps) % timecode::frames_per_day(fps, true));
+                if (!tenth) expect_tc("dropped label", timecode::normalize(TimeCode::hmsf(next_hh, next_mm, 0, 0, false, true), fps), after);
+            }
+        }
+    }
+}
+
+// fields out of range are counted as is, and normalize() wraps around 24 hours
+void test_out_of_range() {
+    for (const FrameRate fps : RATES) {
+        for (int df = 0; df < 2; ++df) {
+            if (df && !timecode::is_drop_frame_rate(fps)) continue;
+            const uint32_t fpd = timecode::frames_per_day(fps, df);
+            for (uint32_t hh = 0; hh < 256; ++hh) {
+                const uint8_t minutes[] {0, 1, 9, 10, 59, 99, 255};
+                for (const uint8_t mm : minutes) {
+                    const TimeCode tc = TimeCode::hmsf((uint8_t)hh, mm, 0, 4, false, df);  // frame 4 is not dropped at any rate
+                    const uint32_t expected = reference_frames(tc, fps);
+                    expect_frames("out of range", tc, fps, expected);
+                    expect_tc("normalize", timecode::normalize(tc, fps), timecode::from_frames(expected % fpd, fps, df));
+                }
+            }
+        }
+    }
+    const TimeCode h48 = TimeCode::hmsf(48, 0, 0, 0, false, true);
+    expect_frames("48 hours", h48, FrameRate::FPS_29_97, 2 * timecode::frames_per_day(FrameRate::FPS_29_97, true));
+    expect_tc("48 hours", timecode::normalize(h48, FrameRate::FPS_29_97), TimeCode::hmsf(0, 0, 0, 0, false, true));
+}
+
+// every label of a day (CF / DF on and off) through the BCD time data format and back
+// (the frame byte has 2 bits for the tens digit, so the format counts up to 30 frames only)
+void test_bcd() {
+    for (uint8_t hh = 0; hh < 24; ++hh)
+        for (uint8_t mm = 0; mm < 60; ++mm)
+            for (uint8_t ss = 0; ss < 60; ++ss)
+                for (uint8_t ff = 0; ff < 30; ++ff) {
+                    const TimeCode tc = TimeCode::hmsf(hh, mm, ss, ff, ff & 2, ff & 1);
+                    uint8_t data[4];
+                    tc.encode_bcd(data);
+                    expect_tc("bcd", TimeCode::decode_bcd(data), tc);
+                }
+    // 01:23:45;29 DF
+    const uint8_t data[4] {0x69, 0x45, 0x23, 0x01};
+    expect_tc("bcd bytes", TimeCode::decode_bcd(data), TimeCode::hmsf(1, 23, 45, 29, false, true));
+}
+
+}  // namespace
+
+int main() {
+    test_round_trip();
+    test_df_boundaries();
+    test_out_of_range();
+    test_bcd();
+    printf("%zu checks %zu failures %s\n", n_checks, n_failures, n_failures ? "FAIL" : "OK");
+    return n_failures ? 1 : 0;
+}